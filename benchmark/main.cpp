@@ -0,0 +1,125 @@
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <string_view>
+
+#include "../include/squeeze/squeeze.h"
+
+//
+// Measures how fast strings can be decoded with each of the Huffman encoder options.
+// Build in release mode for meaningful results.
+//
+
+static constexpr auto buildStrings = [] {
+    return std::to_array<std::string_view>({
+        "To be, or not to be--that is the question:\n"
+        "Whether 'tis nobler in the mind to suffer\n"
+        "The slings and arrows of outrageous fortune\n"
+        "Or to take arms against a sea of troubles\n"
+        "And by opposing end them. To die, to sleep--\n"
+        "No more--and by a sleep to say we end\n"
+        "The heartache, and the thousand natural shocks\n"
+        "That flesh is heir to. 'Tis a consummation\n"
+        "Devoutly to be wished. To die, to sleep--\n"
+        "To sleep--perchance to dream: ay, there's the rub,\n"
+        "For in that sleep of death what dreams may come\n"
+        "When we have shuffled off this mortal coil,\n"
+        "Must give us pause. There's the respect\n"
+        "That makes calamity of so long life.\n"
+        "For who would bear the whips and scorns of time,\n"
+        "Th' oppressor's wrong, the proud man's contumely\n"
+        "The pangs of despised love, the law's delay,\n"
+        "The insolence of office, and the spurns\n"
+        "That patient merit of th' unworthy takes,\n"
+        "When he himself might his quietus make\n"
+        "With a bare bodkin? Who would fardels bear,\n"
+        "To grunt and sweat under a weary life,\n"
+        "But that the dread of something after death,\n"
+        "The undiscovered country, from whose bourn\n"
+        "No traveller returns, puzzles the will,\n"
+        "And makes us rather bear those ills we have\n"
+        "Than fly to others that we know not of?\n"
+        "Thus conscience does make cowards of us all,\n"
+        "And thus the native hue of resolution\n"
+        "Is sicklied o'er with the pale cast of thought,\n"
+        "And enterprise of great pitch and moment\n"
+        "With this regard their currents turn awry\n"
+        "And lose the name of action. -- Soft you now,\n"
+        "The fair Ophelia! -- Nymph, in thy orisons\n"
+        "Be all my sins remembered.",
+
+        "All the world's a stage,\n"
+        "And all the men and women merely players;\n"
+        "They have their exits and their entrances,\n"
+        "And one man in his time plays many parts,\n"
+        "His acts being seven ages. At first, the infant,\n"
+        "Mewling and puking in the nurse's arms.\n"
+        "Then the whining schoolboy, with his satchel\n"
+        "And shining morning face, creeping like a snail\n"
+        "Unwillingly to school. And then the lover,\n"
+        "Sighing like a furnace, with a woeful ballad\n"
+        "Made to his mistress' eyebrow. Then a soldier,\n"
+        "Full of strange oaths and bearded like the pard,\n"
+        "Jealous in honor, sudden and quick in quarrel,\n"
+        "Seeking the bubble reputation\n"
+        "Even in the cannon's mouth. And then the justice,\n"
+        "In fair round belly with good capon lined,\n"
+        "With eyes severe and beard of formal cut,\n"
+        "Full of wise saws and modern instances;\n"
+        "And so he plays his part. The sixth age shifts\n"
+        "Into the lean and slippered pantaloon,\n"
+        "With spectacles on nose and pouch on side;\n"
+        "His youthful hose, well saved, a world too wide\n"
+        "For his shrunk shank, and his big manly voice,\n"
+        "Turning again toward childish treble, pipes\n"
+        "And whistles in his sound. Last scene of all,\n"
+        "That ends this strange eventful history,\n"
+        "Is second childishness and mere oblivion,\n"
+        "Sans teeth, sans eyes, sans taste, sans everything."
+    });
+};
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr std::size_t Iterations = 20000;
+
+// decode every string in the table repeatedly, and report the decode rate and table size
+template<typename TEncoder>
+static void Run(char const *name)
+{
+    static constexpr auto table = squeeze::StringTable<TEncoder>(buildStrings);
+
+    std::array<char, 4096> buffer{};
+    std::size_t checksum{0};
+    std::size_t decoded{0};
+
+    auto const start = Clock::now();
+    for(std::size_t i{0}; i < Iterations; ++i) {
+        for(std::size_t s{0}; s < table.count(); ++s) {
+            auto const n = table.decode_into(s, buffer);
+            checksum += static_cast<unsigned char>(buffer[n - 1]);
+            decoded += n;
+        }
+    }
+    auto const elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::printf("%-36s %8.1f MB/s %8zu bytes  (checksum %zu)\n",
+                name, static_cast<double>(decoded) / elapsed / 1e6, sizeof(table), checksum);
+}
+
+int main()
+{
+    using namespace squeeze;
+
+    static constexpr auto Fast = huffman::Options{.LookupBits = 10, .MaxCodeLength = 12, .Decoder = huffman::DecodeMode::Fast};
+
+    Run<HuffmanEncoder>("HuffmanEncoder");
+    Run<TableHuffmanEncoder>("TableHuffmanEncoder");
+    Run<CanonicalHuffmanEncoder>("CanonicalHuffmanEncoder");
+    Run<FastHuffmanEncoder>("FastHuffmanEncoder");
+    Run<BasicHuffmanEncoder<huffman::Options{Fast.LookupBits, Fast.MaxCodeLength, Fast.Decoder, 256, 2}>>("Fast, 2 interleaved streams");
+    Run<BasicHuffmanEncoder<huffman::Options{Fast.LookupBits, Fast.MaxCodeLength, Fast.Decoder, 256, 3}>>("Fast, 3 interleaved streams");
+    Run<BasicHuffmanEncoder<huffman::Options{Fast.LookupBits, Fast.MaxCodeLength, Fast.Decoder, 256, 4}>>("Fast, 4 interleaved streams");
+
+    return 0;
+}
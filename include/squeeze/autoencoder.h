@@ -0,0 +1,103 @@
+#ifndef SQUEEZE_AUTOENCODER_H
+#define SQUEEZE_AUTOENCODER_H
+
+#include <array>
+#include <cstddef>
+#include <tuple>
+
+#include "concepts.h"
+#include "nilencoder.h"
+#include "huffmanencoder.h"
+#include "lzencoder.h"
+#include "tokenencoder.h"
+#include "fsstencoder.h"
+#include "tansencoder.h"
+#include "contexthuffmanencoder.h"
+#include "hybridencoder.h"
+
+namespace squeeze
+{
+    namespace autoselect {
+
+        // What an AutoEncoder picks its encoder for
+        enum class Objective
+        {
+            // The encoder with the smallest footprint, the encoded strings plus their index and tables
+            Size,
+            // The encoder with the cheapest decode that is still smaller than the first (baseline) encoder.
+            // If none are, the baseline is used.
+            Speed
+        };
+
+        // The estimated relative cost of decoding a character with each encoder. Only the order matters.
+        template<typename TEncoder>
+        constexpr std::size_t DecodeCost = 100;
+
+        template<> constexpr std::size_t DecodeCost<NilEncoder> = 1;
+        template<> constexpr std::size_t DecodeCost<FsstEncoder> = 2;
+        template<> constexpr std::size_t DecodeCost<TokenEncoder> = 3;
+        template<> constexpr std::size_t DecodeCost<LzEncoder> = 4;
+        template<> constexpr std::size_t DecodeCost<FastHuffmanEncoder> = 6;
+        template<> constexpr std::size_t DecodeCost<TansEncoder> = 7;
+        template<> constexpr std::size_t DecodeCost<HuffmanLzEncoder> = 8;
+        template<> constexpr std::size_t DecodeCost<TableHuffmanEncoder> = 10;
+        template<> constexpr std::size_t DecodeCost<HybridEncoder> = 11;
+        template<> constexpr std::size_t DecodeCost<CanonicalHuffmanEncoder> = 12;
+        template<> constexpr std::size_t DecodeCost<ContextHuffmanEncoder> = 14;
+        template<> constexpr std::size_t DecodeCost<HuffmanEncoder> = 16;
+
+        // The index of the encoder that best meets the objective, given the footprint and decode cost of each
+        template<std::size_t NUM_ENCODERS>
+        constexpr std::size_t Choose(Objective objective, std::array<std::size_t, NUM_ENCODERS> const &sizes, std::array<std::size_t, NUM_ENCODERS> const &costs)
+        {
+            static_assert(NUM_ENCODERS > 0, "AutoEncoder needs at least one encoder to choose from");
+
+            std::size_t best{0};
+            for(std::size_t i{1}; i < NUM_ENCODERS; ++i) {
+                bool const smaller = sizes.at(i) < sizes.at(best) || (sizes.at(i) == sizes.at(best) && costs.at(i) < costs.at(best));
+                bool const faster = costs.at(i) < costs.at(best) || (costs.at(i) == costs.at(best) && sizes.at(i) < sizes.at(best));
+
+                if(objective == Objective::Size && smaller) {
+                    best = i;
+                } else if(objective == Objective::Speed && sizes.at(i) < sizes.at(0) && (best == 0 || faster)) {
+                    best = i;
+                }
+            }
+
+            return best;
+        }
+    }
+
+    //
+    // Compiles the strings with each of TEncoders, and keeps the one that best meets the objective. The
+    // result is the chosen encoder's own, so there is no cost at run time for the choice.
+    //
+    // Note that every encoder is compiled, so this takes as long to compile as all of them together.
+    //
+    template<autoselect::Objective OBJECTIVE, typename... TEncoders>
+    class BasicAutoEncoder
+    {
+    public:
+
+        static constexpr auto Compile(CallableGivesIterableStringViews auto makeStringsLambda)
+        {
+            constexpr std::array<std::size_t, sizeof...(TEncoders)> sizes{ sizeof(decltype(TEncoders::Compile(makeStringsLambda)))... };
+            constexpr std::array<std::size_t, sizeof...(TEncoders)> costs{ autoselect::DecodeCost<TEncoders>... };
+
+            using Chosen = std::tuple_element_t<autoselect::Choose(OBJECTIVE, sizes, costs), std::tuple<TEncoders...>>;
+
+            constexpr auto const encoding = Chosen::Compile(makeStringsLambda);
+
+            return encoding;
+        }
+    };
+
+    // Picks from the uncompressed strings and the general purpose encoders. The other encoders are left out to
+    // keep compile times down, add them with BasicAutoEncoder if wanted.
+    template<autoselect::Objective OBJECTIVE = autoselect::Objective::Size>
+    using AutoEncoder = BasicAutoEncoder<OBJECTIVE,
+        NilEncoder, HuffmanEncoder, CanonicalHuffmanEncoder, FastHuffmanEncoder, LzEncoder, TokenEncoder, FsstEncoder, TansEncoder>;
+
+}
+
+#endif //SQUEEZE_AUTOENCODER_H
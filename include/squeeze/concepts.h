@@ -13,6 +13,16 @@ namespace squeeze
     };
 
 
+    // A string for every key from Low to High inclusive
+    template<typename TKey>
+    struct KeyedRangeStringView
+    {
+        TKey Low;
+        TKey High;
+        std::string_view Value;
+    };
+
+
     template<typename T>
     concept CallableGivesIterableStringViews = requires(T t) {
         t();            // is callable
@@ -30,6 +40,15 @@ namespace squeeze
         std::is_same_v<decltype(t().begin()), KeyedStringView<K>>;
     };
 
+    template<typename T, typename K>
+    concept CallableGivesIterableKeyedRangeStringViews = requires(T t, K k)
+    {
+        t();            // is callable
+        requires std::input_iterator<decltype(t().begin())>;    // result has iterators
+        // result iterates through string_views
+        std::is_same_v<decltype(t().begin()), KeyedRangeStringView<K>>;
+    };
+
 
 }
 
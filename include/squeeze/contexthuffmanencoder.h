@@ -0,0 +1,558 @@
+#ifndef SQUEEZE_CONTEXTHUFFMANENCODER_H
+#define SQUEEZE_CONTEXTHUFFMANENCODER_H
+
+#include <string_view>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <span>
+
+#include "concepts.h"
+#include "huffmanencoder.h"
+#include "lib/bit_reader.h"
+#include "lib/bit_stream.h"
+#include "lib/decode_iterator.h"
+#include "lib/smallest_uint.h"
+
+namespace squeeze
+{
+    namespace context {
+
+        // Compile time options controlling how a ContextHuffmanEncoder builds its codes
+        struct Options
+        {
+            // The characters that come before another are grouped into this many classes, and each
+            // class has its own canonical Huffman code for the character that follows. More classes
+            // follow the strings more closely but each one stores its own code.
+            std::size_t ContextClasses{4};
+
+            // Canonical codes are limited to this many bits
+            std::size_t MaxCodeLength{12};
+        };
+
+        // The character taken to come before the first character of each string
+        constexpr char StartContext = '\0';
+
+        // n log2 n, the building block of the number of bits needed to code counts. Only used at compile
+        // time, where <cmath> is not available.
+        constexpr double NLog2N(std::size_t n)
+        {
+            if(n == 0) {
+                return 0.0;
+            }
+
+            // n = 2^exponent * x, with x in [1, 2)
+            auto const exponent = std::bit_width(n) - 1;
+            auto const x = static_cast<double>(n) / static_cast<double>(std::uint64_t{1} << exponent);
+
+            // ln(x) = 2 atanh((x - 1) / (x + 1)), which converges quickly for x in [1, 2)
+            auto const y = (x - 1.0) / (x + 1.0);
+            double term{y};
+            double sum{0};
+            for(int k{1}; k < 16; k += 2) {
+                sum += term / k;
+                term *= y * y;
+            }
+
+            constexpr double Ln2 = 0.693147180559945309417;
+            return static_cast<double>(n) * (static_cast<double>(exponent) + 2.0 * sum / Ln2);
+        }
+
+        // The characters of the strings, and the characters that come before another
+        struct Alphabet
+        {
+            std::array<char, 256> Chars{};
+            std::size_t NumChars{0};
+            std::array<std::size_t, 256> IndexOf{};         // the index of each character in Chars
+
+            std::array<char, 256> Predecessors{};
+            std::size_t NumPredecessors{0};
+            std::array<std::size_t, 256> PredecessorIndex{};
+            std::size_t ClassMapSize{0};                    // one more than the largest predecessor value
+        };
+
+        static constexpr auto BuildAlphabet(CallableGivesIterableStringViews auto makeStringsLambda)
+        {
+            constexpr auto st = makeStringsLambda();
+
+            std::array<bool, 256> used{};
+            std::array<bool, 256> predecessor{};
+            for(std::string_view const str : st) {
+                auto previous = StartContext;
+                for(auto const c : str) {
+                    used.at(static_cast<unsigned char>(c)) = true;
+                    predecessor.at(static_cast<unsigned char>(previous)) = true;
+                    previous = c;
+                }
+            }
+
+            Alphabet result{};
+            for(std::size_t c{0}; c < 256; ++c) {
+                if(used.at(c)) {
+                    result.IndexOf.at(c) = result.NumChars;
+                    result.Chars.at(result.NumChars++) = static_cast<char>(c);
+                }
+                if(predecessor.at(c)) {
+                    result.PredecessorIndex.at(c) = result.NumPredecessors;
+                    result.Predecessors.at(result.NumPredecessors++) = static_cast<char>(c);
+                    result.ClassMapSize = c + 1;
+                }
+            }
+
+            return result;
+        }
+
+        // The context class of each character that comes before another
+        struct Classes
+        {
+            std::array<std::size_t, 256> ClassOf{};
+            std::size_t NumClasses{0};
+        };
+
+        //
+        // Group the predecessors into classes. Each predecessor starts in a class of its own, then the two
+        // classes whose merged counts of following characters cost the fewest extra bits to code are merged,
+        // until there are no more than MAX_CLASSES.
+        //
+        template<std::size_t MAX_CLASSES, std::size_t NUM_CHARS, std::size_t NUM_PREDECESSORS, std::size_t TOTAL_LENGTH>
+        static constexpr auto BuildClasses(CallableGivesIterableStringViews auto makeStringsLambda, Alphabet const &alphabet)
+        {
+            constexpr auto st = makeStringsLambda();
+
+            // how often each character follows each class
+            std::array<std::array<std::size_t, NUM_CHARS>, NUM_PREDECESSORS> counts{};
+            for(std::string_view const str : st) {
+                auto previous = StartContext;
+                for(auto const c : str) {
+                    auto const p = alphabet.PredecessorIndex.at(static_cast<unsigned char>(previous));
+                    ++counts.at(p).at(alphabet.IndexOf.at(static_cast<unsigned char>(c)));
+                    previous = c;
+                }
+            }
+
+            std::array<std::size_t, NUM_PREDECESSORS> totals{};
+            std::array<bool, NUM_PREDECESSORS> alive{};
+            std::array<std::size_t, NUM_PREDECESSORS> mergedInto{};
+            for(std::size_t p{0}; p < NUM_PREDECESSORS; ++p) {
+                totals.at(p) = std::accumulate(counts.at(p).begin(), counts.at(p).end(), std::size_t{0});
+                alive.at(p) = true;
+                mergedInto.at(p) = p;
+            }
+
+            // no count is more than the total length, so n log2 n is only worked out once for each
+            std::array<double, TOTAL_LENGTH + 1> nLog2N{};
+            for(std::size_t n{0}; n <= TOTAL_LENGTH; ++n) {
+                nLog2N.at(n) = NLog2N(n);
+            }
+
+            // the extra bits needed to code the characters after two classes with one code rather than two.
+            // Only the characters that follow both classes change the sum of the character terms.
+            // This is the inner loop of the clustering, so it works through pointers to stay inside the
+            // compiler's limit on constexpr operations.
+            auto const mergeCost = [&](std::size_t a, std::size_t b) {
+                auto const *f = nLog2N.data();
+                auto const *countsA = counts.at(a).data();
+                auto const *countsB = counts.at(b).data();
+
+                double cost = f[totals.at(a) + totals.at(b)] - f[totals.at(a)] - f[totals.at(b)];
+                for(std::size_t c{0}; c < NUM_CHARS; ++c) {
+                    if(countsA[c] != 0 && countsB[c] != 0) {
+                        cost -= f[countsA[c] + countsB[c]] - f[countsA[c]] - f[countsB[c]];
+                    }
+                }
+                return cost;
+            };
+
+            std::array<std::array<double, NUM_PREDECESSORS>, NUM_PREDECESSORS> costs{};
+            for(std::size_t a{0}; a < NUM_PREDECESSORS; ++a) {
+                for(std::size_t b{a + 1}; b < NUM_PREDECESSORS; ++b) {
+                    costs.at(a).at(b) = mergeCost(a, b);
+                }
+            }
+
+            for(auto numAlive = NUM_PREDECESSORS; numAlive > MAX_CLASSES; --numAlive) {
+                std::size_t bestA{0};
+                std::size_t bestB{0};
+                double bestCost{std::numeric_limits<double>::max()};
+                for(std::size_t a{0}; a < NUM_PREDECESSORS; ++a) {
+                    for(std::size_t b{a + 1}; alive.at(a) && b < NUM_PREDECESSORS; ++b) {
+                        if(alive.at(b) && costs.at(a).at(b) < bestCost) {
+                            bestA = a;
+                            bestB = b;
+                            bestCost = costs.at(a).at(b);
+                        }
+                    }
+                }
+
+                // merge b into a, and update the costs of merging with a
+                for(std::size_t c{0}; c < NUM_CHARS; ++c) {
+                    counts.at(bestA).at(c) += counts.at(bestB).at(c);
+                }
+                totals.at(bestA) += totals.at(bestB);
+                alive.at(bestB) = false;
+                for(auto &into : mergedInto) {
+                    if(into == bestB) {
+                        into = bestA;
+                    }
+                }
+
+                for(std::size_t x{0}; x < NUM_PREDECESSORS; ++x) {
+                    if(alive.at(x) && x != bestA) {
+                        costs.at(std::min(x, bestA)).at(std::max(x, bestA)) = mergeCost(x, bestA);
+                    }
+                }
+            }
+
+            // number the classes that are left in order
+            Classes result{};
+            std::array<std::size_t, NUM_PREDECESSORS> classOf{};
+            for(std::size_t p{0}; p < NUM_PREDECESSORS; ++p) {
+                if(alive.at(p)) {
+                    classOf.at(p) = result.NumClasses++;
+                }
+            }
+            for(std::size_t p{0}; p < NUM_PREDECESSORS; ++p) {
+                result.ClassOf.at(static_cast<unsigned char>(alphabet.Predecessors.at(p))) = classOf.at(mergedInto.at(p));
+            }
+
+            return result;
+        }
+
+        // The code for a character, with the first bit to write in the least significant position
+        struct Code
+        {
+            std::uint64_t Bits{0};
+            std::size_t Length{0};
+        };
+
+        // The canonical code of each class
+        template<std::size_t NUM_CHARS, std::size_t NUM_CLASSES, std::size_t MAX_LENGTH>
+        struct ClassCodes
+        {
+            std::array<std::array<char, NUM_CHARS>, NUM_CLASSES> Symbols{};        // in canonical order
+            std::array<std::size_t, NUM_CLASSES> NumSymbols{};
+            std::array<std::array<std::uint16_t, MAX_LENGTH + 1>, NUM_CLASSES> LengthCounts{};
+            std::array<std::array<Code, NUM_CHARS>, NUM_CLASSES> Codes{};          // by alphabet index
+        };
+
+        //
+        // Build a length limited canonical code for the characters that follow each class
+        //
+        template<std::size_t MAX_LENGTH, std::size_t NUM_CHARS, std::size_t NUM_CLASSES>
+        static constexpr auto BuildClassCodes(CallableGivesIterableStringViews auto makeStringsLambda, Alphabet const &alphabet, Classes const &classes)
+        {
+            constexpr auto st = makeStringsLambda();
+
+            std::array<std::array<std::size_t, NUM_CHARS>, NUM_CLASSES> counts{};
+            for(std::string_view const str : st) {
+                auto previous = StartContext;
+                for(auto const c : str) {
+                    auto const k = classes.ClassOf.at(static_cast<unsigned char>(previous));
+                    ++counts.at(k).at(alphabet.IndexOf.at(static_cast<unsigned char>(c)));
+                    previous = c;
+                }
+            }
+
+            ClassCodes<NUM_CHARS, NUM_CLASSES, MAX_LENGTH> result{};
+
+            for(std::size_t k{0}; k < NUM_CLASSES; ++k) {
+                // the frequency table of the characters that follow this class, in character order
+                std::array<huffman::CharFrequency, NUM_CHARS> ft{};
+                std::array<std::size_t, NUM_CHARS> charIndex{};
+                std::size_t n{0};
+                for(std::size_t a{0}; a < NUM_CHARS; ++a) {
+                    if(counts.at(k).at(a) != 0) {
+                        charIndex.at(n) = a;
+                        ft.at(n++) = huffman::CharFrequency{alphabet.Chars.at(a), counts.at(k).at(a)};
+                    }
+                }
+
+                auto const lengths = huffman::CalculateLimitedCodeLengths<MAX_LENGTH>(ft, n);
+
+                // assign consecutive codes ordered by length then character, as huffman::BuildCanonicalCode does
+                std::array<std::size_t, NUM_CHARS> order{};
+                std::iota(order.begin(), order.begin() + static_cast<std::ptrdiff_t>(n), std::size_t{0});
+                std::sort(order.begin(), order.begin() + static_cast<std::ptrdiff_t>(n), [&](auto a, auto b) {
+                    return lengths.at(a) < lengths.at(b) || (lengths.at(a) == lengths.at(b) && a < b);
+                });
+
+                std::uint64_t code{0};
+                std::size_t prevLength{n == 0 ? 0 : lengths.at(order.at(0))};
+                for(std::size_t i{0}; i < n; ++i) {
+                    auto const len = lengths.at(order.at(i));
+                    code <<= (len - prevLength);
+                    prevLength = len;
+
+                    // the code is written most significant bit first
+                    Code cd{0, len};
+                    for(std::size_t b{0}; b < len; ++b) {
+                        cd.Bits |= ((code >> (len - 1 - b)) & 1u) << b;
+                    }
+
+                    result.Codes.at(k).at(charIndex.at(order.at(i))) = cd;
+                    result.Symbols.at(k).at(i) = ft.at(order.at(i)).c;
+                    result.LengthCounts.at(k).at(len) += 1;
+                    ++code;
+                }
+                result.NumSymbols.at(k) = n;
+            }
+
+            return result;
+        }
+
+
+        // A non-templated view of the class of each predecessor, and the canonical code of each class
+        struct Tables
+        {
+            std::span<std::uint8_t const> ClassMap;         // ClassBits for each predecessor, never split over two bytes
+            std::size_t ClassBits;                          // 0, 1, 2, 4 or 8
+            std::span<char const> Symbols;
+            std::span<std::uint16_t const> SymbolStarts;    // where each class starts in Symbols, with the end last
+            std::span<std::uint16_t const> LengthCounts;    // MaxCodeLength + 1 for each class
+            std::size_t MaxCodeLength;
+
+            // the context class of the character after previous
+            [[nodiscard]] constexpr std::size_t class_of(char previous) const
+            {
+                if(ClassBits == 0)
+                    return 0;
+
+                auto const bit = static_cast<unsigned char>(previous) * ClassBits;
+                return (ClassMap[bit / 8] >> (bit % 8)) & ((1u << ClassBits) - 1);
+            }
+
+            // the code book for the character after previous
+            [[nodiscard]] constexpr huffman::CodeBook code_book(char previous) const
+            {
+                auto const k = class_of(previous);
+
+                return huffman::CodeBook{
+                    {},
+                    huffman::Node::LeafLink('\0'),
+                    Symbols.subspan(SymbolStarts[k], static_cast<std::size_t>(SymbolStarts[k + 1] - SymbolStarts[k])),
+                    LengthCounts.subspan(k * (MaxCodeLength + 1), MaxCodeLength + 1),
+                    {},
+                    0 };
+            }
+        };
+
+
+        // Represents a string that is being accessed, decoding a character at a time as it is iterated.
+        class IterableString
+        {
+        private:
+            // the reader, and the previous character that picks the code book for the next
+            struct Cursor
+            {
+                lib::bit_reader Reader{};
+                char Previous{StartContext};
+            };
+
+        public:
+            using Iterator = lib::decode_iterator<IterableString>;
+            friend Iterator;
+
+            constexpr IterableString(std::span<std::uint8_t const> stream, std::size_t firstBit, std::size_t stringLength, Tables tables)
+                : m_Stream{stream}
+                , m_FirstBit{firstBit}
+                , m_StringLength{stringLength}
+                , m_Tables{tables}
+            {}
+
+            [[nodiscard]] constexpr std::size_t size() const { return m_StringLength; }
+
+            [[nodiscard]] constexpr Iterator begin() const { return Iterator{*this}; }
+            [[nodiscard]] constexpr Iterator end() const { return Iterator{typename Iterator::EndPosition{*this}}; }
+
+            // Decode the string into dest, stopping early if dest is too small.
+            // Returns the number of characters written.
+            constexpr std::size_t decode_into(std::span<char> dest) const
+            {
+                return decode_n(dest.begin(), std::min(dest.size(), m_StringLength));
+            }
+
+            // Decode the whole string to the output iterator. Returns the number of characters written.
+            template<typename TOutputIt>
+            constexpr std::size_t copy_to(TOutputIt out) const
+            {
+                return decode_n(out, m_StringLength);
+            }
+
+        private:
+            [[nodiscard]] constexpr Cursor start() const { return Cursor{lib::bit_reader{m_Stream, m_FirstBit}, StartContext}; }
+
+            constexpr char next(Cursor &cursor) const
+            {
+                cursor.Previous = m_Tables.code_book(cursor.Previous).decode(cursor.Reader);
+                return cursor.Previous;
+            }
+
+            template<typename TOutputIt>
+            constexpr std::size_t decode_n(TOutputIt out, std::size_t count) const
+            {
+                auto cursor = start();
+                for(std::size_t i{0}; i < count; ++i) {
+                    *out++ = next(cursor);
+                }
+                return count;
+            }
+
+            std::span<std::uint8_t const> m_Stream;
+            std::size_t m_FirstBit;
+            std::size_t m_StringLength;
+            Tables m_Tables;
+        };
+
+
+        template<typename TEntryIndex, std::size_t NUM_ENCODED_BITS, std::size_t NUM_CLASSES, std::size_t NUM_SYMBOLS, std::size_t MAX_CODE_LENGTH, std::size_t CLASS_MAP_SIZE>
+        struct Encoding
+        {
+            static constexpr std::size_t NumEntries = TEntryIndex::NumEntries;
+            static constexpr std::size_t NumEncodedBits = NUM_ENCODED_BITS;
+            // rounded up to a power of two so that a class is read from a single byte
+            static constexpr std::size_t ClassBits = (NUM_CLASSES > 1) ? std::bit_ceil(lib::bits_needed(NUM_CLASSES - 1)) : 0;
+
+            using StringType = IterableString;
+
+            constexpr StringType operator[](std::size_t idx) const
+            {
+                // bounds check without exceptions
+                if(idx >= NumEntries)
+                    return bad_string();
+
+                auto const entry = m_Entries[idx];
+                return StringType{m_CompressedStream.data(), entry.FirstBit, entry.OriginalStringLength, tables()};
+            }
+
+            // provide a value that is an implementation defined value representing a
+            // bad key or index was requested.
+            constexpr StringType bad_string() const {
+                // this is an empty string
+                return StringType{{}, 0, 0, tables()};
+            }
+
+            // the context class of the character after previous
+            constexpr std::size_t class_of(char previous) const
+            {
+                return tables().class_of(previous);
+            }
+
+            TEntryIndex m_Entries;
+            lib::bit_stream<NUM_ENCODED_BITS> m_CompressedStream;
+            std::array<std::uint8_t, (CLASS_MAP_SIZE * ClassBits + 7) / 8> m_ClassMap;
+            std::array<char, NUM_SYMBOLS> m_Symbols;
+            std::array<std::uint16_t, NUM_CLASSES + 1> m_SymbolStarts;
+            std::array<std::uint16_t, NUM_CLASSES * (MAX_CODE_LENGTH + 1)> m_LengthCounts;
+
+        private:
+            constexpr Tables tables() const
+            {
+                return Tables{m_ClassMap, ClassBits, m_Symbols, m_SymbolStarts, m_LengthCounts, MAX_CODE_LENGTH};
+            }
+        };
+
+
+        template<Options OPTIONS = Options{}>
+        static constexpr auto MakeEncoding(CallableGivesIterableStringViews auto makeStringsLambda)
+        {
+            static_assert(OPTIONS.ContextClasses > 0, "There must be at least one context class");
+            static_assert(OPTIONS.MaxCodeLength > 0 && OPTIONS.MaxCodeLength <= 32, "MaxCodeLength must be from 1 to 32");
+
+            // get the string table to work with
+            constexpr auto st = makeStringsLambda();
+            constexpr auto NumStrings = static_cast<std::size_t>(std::distance(st.begin(), st.end()));
+            constexpr auto TotalLength = std::accumulate(
+                    st.begin(), st.end(), std::size_t{0},
+                    [](auto total, auto const &sv){ return total + sv.size(); });
+            constexpr auto MaxStringLength = std::accumulate(
+                    st.begin(), st.end(), std::size_t{0},
+                    [](std::size_t longest, auto const &sv){ return std::max(longest, sv.size()); });
+
+            constexpr auto alphabet = BuildAlphabet(makeStringsLambda);
+            static_assert(alphabet.NumChars <= (std::size_t{1} << OPTIONS.MaxCodeLength), "MaxCodeLength is too short to encode all characters");
+
+            constexpr auto classes = BuildClasses<OPTIONS.ContextClasses, alphabet.NumChars, alphabet.NumPredecessors, TotalLength>(makeStringsLambda, alphabet);
+            constexpr auto codes = BuildClassCodes<OPTIONS.MaxCodeLength, alphabet.NumChars, classes.NumClasses>(makeStringsLambda, alphabet, classes);
+            constexpr auto NumSymbols = std::accumulate(codes.NumSymbols.begin(), codes.NumSymbols.end(), std::size_t{0});
+            static_assert(NumSymbols <= std::numeric_limits<std::uint16_t>::max(), "Too many symbols across the context classes, use fewer ContextClasses");
+
+            // the code for c after previous
+            constexpr auto CodeFor = [=](char previous, char c) {
+                return codes.Codes.at(classes.ClassOf.at(static_cast<unsigned char>(previous)))
+                                  .at(alphabet.IndexOf.at(static_cast<unsigned char>(c)));
+            };
+
+            constexpr auto TotalEncodedBits = [=]() {
+                std::size_t bits{0};
+                for(std::string_view const str : st) {
+                    auto previous = StartContext;
+                    for(auto const c : str) {
+                        bits += CodeFor(previous, c).Length;
+                        previous = c;
+                    }
+                }
+                return bits;
+            }();
+
+            using EntryIndexType = huffman::EntryIndex<NumStrings, TotalEncodedBits, MaxStringLength>;
+            Encoding<EntryIndexType, TotalEncodedBits, classes.NumClasses, NumSymbols, OPTIONS.MaxCodeLength, alphabet.ClassMapSize> result{};
+
+            // the class of each predecessor, and the code of each class
+            for(std::size_t p{0}; result.ClassBits > 0 && p < alphabet.NumPredecessors; ++p) {
+                auto const c = static_cast<unsigned char>(alphabet.Predecessors.at(p));
+                auto const bit = c * result.ClassBits;
+                result.m_ClassMap.at(bit / 8) |= static_cast<std::uint8_t>(classes.ClassOf.at(c) << (bit % 8));
+            }
+
+            std::size_t symbol{0};
+            for(std::size_t k{0}; k < classes.NumClasses; ++k) {
+                result.m_SymbolStarts.at(k) = static_cast<std::uint16_t>(symbol);
+                for(std::size_t i{0}; i < codes.NumSymbols.at(k); ++i) {
+                    result.m_Symbols.at(symbol++) = codes.Symbols.at(k).at(i);
+                }
+                std::copy(codes.LengthCounts.at(k).begin(), codes.LengthCounts.at(k).end(),
+                          result.m_LengthCounts.begin() + static_cast<std::ptrdiff_t>(k * (OPTIONS.MaxCodeLength + 1)));
+            }
+            result.m_SymbolStarts.at(classes.NumClasses) = static_cast<std::uint16_t>(symbol);
+
+            std::size_t entry{0};
+            std::size_t bit{0};
+            for(std::string_view const str : st) {
+                result.m_Entries.set(entry++, huffman::Entry{bit, str.size()});
+
+                auto previous = StartContext;
+                for(auto const c : str) {
+                    auto const code = CodeFor(previous, c);
+                    result.m_CompressedStream.write(bit, code.Bits, code.Length);
+                    bit += code.Length;
+                    previous = c;
+                }
+            }
+
+            return result;
+        }
+    }
+
+    template<context::Options OPTIONS = context::Options{}>
+    class BasicContextHuffmanEncoder
+    {
+    public:
+
+        static constexpr auto Compile(CallableGivesIterableStringViews auto makeStringsLambda)
+        {
+            constexpr auto const encoding = context::MakeEncoding<OPTIONS>(makeStringsLambda);
+
+            return encoding;
+        }
+    };
+
+    // Canonical Huffman codes chosen by the class of the character before, so common pairs code shorter
+    using ContextHuffmanEncoder = BasicContextHuffmanEncoder<>;
+
+}
+
+#endif //SQUEEZE_CONTEXTHUFFMANENCODER_H
@@ -0,0 +1,490 @@
+#ifndef SQUEEZE_FSSTENCODER_H
+#define SQUEEZE_FSSTENCODER_H
+
+#include <string_view>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <numeric>
+#include <span>
+
+#include "concepts.h"
+#include "huffmanencoder.h"
+#include "nilencoder.h"
+#include "lib/decode_iterator.h"
+
+namespace squeeze
+{
+    namespace fsst {
+
+        // the longest string a symbol can stand for
+        constexpr std::size_t MaxSymbolLength = 8;
+
+        // the code that says the next byte is a character not in the symbol table
+        constexpr unsigned char Escape = 255;
+
+        // Compile time options controlling how an FsstEncoder builds its symbol table
+        struct Options
+        {
+            // The most symbols in the table, up to 255. Every other code is an escape.
+            std::size_t MaxSymbols{255};
+
+            // The number of times the table is refined by encoding the strings with it and
+            // counting what would have been better symbols
+            std::size_t Rounds{5};
+        };
+
+        // The characters of a symbol, padded with zeros so it can always be stored with an 8 byte copy
+        using SymbolBytes = std::array<char, MaxSymbolLength>;
+
+        // A symbol while the table is being built
+        struct Symbol
+        {
+            SymbolBytes Bytes{};
+            std::size_t Length{0};
+
+            constexpr friend auto operator<=>(Symbol const &, Symbol const &) = default;
+
+            [[nodiscard]] constexpr bool matches(std::string_view str, std::size_t pos) const
+            {
+                return Length <= str.size() - pos && std::equal(Bytes.begin(), Bytes.begin() + static_cast<std::ptrdiff_t>(Length), str.begin() + static_cast<std::ptrdiff_t>(pos));
+            }
+
+            // a symbol that is a single character
+            static constexpr Symbol Single(char c)
+            {
+                Symbol result{};
+                result.Bytes.at(0) = c;
+                result.Length = 1;
+                return result;
+            }
+
+            // The characters packed into one integer, with the length to tell apart symbols ending in zeros.
+            // Compares and sorts much faster at compile time than the symbol itself.
+            struct Key
+            {
+                std::uint64_t Bytes{0};
+                std::size_t Length{0};
+
+                constexpr friend auto operator<=>(Key const &, Key const &) = default;
+            };
+
+            [[nodiscard]] constexpr Key key() const
+            {
+                Key result{0, Length};
+                for(std::size_t i{0}; i < Length; ++i) {
+                    result.Bytes |= std::uint64_t{static_cast<unsigned char>(Bytes.at(i))} << (i * 8);
+                }
+                return result;
+            }
+
+            static constexpr Symbol FromKey(Key const &key)
+            {
+                Symbol result{};
+                for(std::size_t i{0}; i < key.Length; ++i) {
+                    result.Bytes.at(i) = static_cast<char>((key.Bytes >> (i * 8)) & 0xFFu);
+                }
+                result.Length = key.Length;
+                return result;
+            }
+
+            // a symbol that is one symbol followed by another
+            static constexpr Symbol Concat(Symbol const &first, Symbol const &second)
+            {
+                Symbol result{first};
+                std::copy_n(second.Bytes.begin(), second.Length, result.Bytes.begin() + static_cast<std::ptrdiff_t>(first.Length));
+                result.Length = first.Length + second.Length;
+                return result;
+            }
+        };
+
+        // The symbol table while it is being built, indexed by first character to find the longest match
+        struct SymbolTable
+        {
+            std::array<Symbol, 255> Symbols{};
+            std::size_t Count{0};
+
+            // symbols ordered by first character then longest first, and where each first character starts
+            std::array<std::uint8_t, 255> ByFirst{};
+            std::array<std::size_t, 257> FirstStart{};
+
+            constexpr void index()
+            {
+                std::iota(ByFirst.begin(), ByFirst.begin() + static_cast<std::ptrdiff_t>(Count), std::uint8_t{0});
+                std::sort(ByFirst.begin(), ByFirst.begin() + static_cast<std::ptrdiff_t>(Count), [this](auto a, auto b) {
+                    auto const fa = static_cast<unsigned char>(Symbols.at(a).Bytes.at(0));
+                    auto const fb = static_cast<unsigned char>(Symbols.at(b).Bytes.at(0));
+                    return fa != fb ? fa < fb : Symbols.at(a).Length > Symbols.at(b).Length;
+                });
+
+                FirstStart.fill(0);
+                for(std::size_t i{0}; i < Count; ++i) {
+                    ++FirstStart.at(static_cast<unsigned char>(Symbols.at(ByFirst.at(i)).Bytes.at(0)) + 1u);
+                }
+                std::partial_sum(FirstStart.begin(), FirstStart.end(), FirstStart.begin());
+            }
+
+            // the longest symbol at pos in the string, or Count if there is none
+            [[nodiscard]] constexpr std::size_t match(std::string_view str, std::size_t pos) const
+            {
+                auto const first = static_cast<unsigned char>(str.at(pos));
+                for(auto i = FirstStart.at(first); i < FirstStart.at(first + 1u); ++i) {
+                    if(Symbols.at(ByFirst.at(i)).matches(str, pos)) {
+                        return ByFirst.at(i);
+                    }
+                }
+                return Count;
+            }
+        };
+
+        // The symbols each code expands to
+        struct Symbols
+        {
+            std::span<SymbolBytes const> Bytes;
+            std::span<std::uint8_t const> Lengths;
+        };
+
+
+        // Represents a string that is being accessed, expanding a code at a time as it is iterated.
+        class IterableString
+        {
+        private:
+            // the next code to expand, and the characters of the current one
+            struct Cursor
+            {
+                std::size_t Code{0};
+                std::span<char const> Run{};
+                std::size_t RunPosition{0};
+            };
+
+        public:
+            using Iterator = lib::decode_iterator<IterableString>;
+            friend Iterator;
+
+            constexpr IterableString(std::span<char const> codes, std::size_t length, Symbols symbols)
+                : m_Codes{codes}
+                , m_Length{length}
+                , m_Symbols{symbols}
+            {}
+
+            [[nodiscard]] constexpr std::size_t size() const { return m_Length; }
+
+            [[nodiscard]] constexpr Iterator begin() const { return Iterator{*this}; }
+            [[nodiscard]] constexpr Iterator end() const { return Iterator{typename Iterator::EndPosition{*this}}; }
+
+            // Decode the string into dest, stopping early if dest is too small.
+            // Returns the number of characters written.
+            constexpr std::size_t decode_into(std::span<char> dest) const
+            {
+                std::size_t i{0};
+                std::size_t done{0};
+
+                if(!std::is_constant_evaluated()) {
+                    // while any symbol fits before the last character to write, store all 8 bytes of it and step
+                    // past its length. Its padding is overwritten by what follows, never left past the end.
+                    auto const limit = std::min(dest.size(), size());
+                    while(i < m_Codes.size() && limit - done >= MaxSymbolLength) {
+                        auto const code = static_cast<unsigned char>(m_Codes[i]);
+                        if(code == Escape) {
+                            dest[done++] = m_Codes[i + 1];
+                            i += 2;
+                        } else {
+                            std::memcpy(dest.data() + done, m_Symbols.Bytes[code].data(), MaxSymbolLength);
+                            done += m_Symbols.Lengths[code];
+                            ++i;
+                        }
+                    }
+                }
+
+                for(; i < m_Codes.size() && done < dest.size(); ++i) {
+                    auto const run = expand(i);
+                    auto const n = std::min(run.size(), dest.size() - done);
+                    std::copy_n(run.begin(), n, dest.begin() + static_cast<std::ptrdiff_t>(done));
+                    done += n;
+                }
+
+                return done;
+            }
+
+            // Decode the whole string to the output iterator. Returns the number of characters written.
+            template<typename TOutputIt>
+            constexpr std::size_t copy_to(TOutputIt out) const
+            {
+                std::size_t done{0};
+                for(std::size_t i{0}; i < m_Codes.size(); ++i) {
+                    auto const run = expand(i);
+                    out = std::copy(run.begin(), run.end(), out);
+                    done += run.size();
+                }
+                return done;
+            }
+
+        private:
+            [[nodiscard]] constexpr Cursor start() const { return Cursor{}; }
+
+            // the next character of the current code, expanding the next code when it is done
+            constexpr char next(Cursor &cursor) const
+            {
+                if(cursor.RunPosition == cursor.Run.size()) {
+                    cursor.Run = expand(cursor.Code);
+                    ++cursor.Code;
+                    cursor.RunPosition = 0;
+                }
+                return cursor.Run[cursor.RunPosition++];
+            }
+
+            // the characters of the code at i, stepping i past an escaped character
+            constexpr std::span<char const> expand(std::size_t &i) const
+            {
+                auto const code = static_cast<unsigned char>(m_Codes[i]);
+                if(code == Escape) {
+                    return m_Codes.subspan(++i, 1);
+                }
+                return std::span<char const>{m_Symbols.Bytes[code]}.first(m_Symbols.Lengths[code]);
+            }
+
+            std::span<char const> m_Codes;
+            std::size_t m_Length;
+            Symbols m_Symbols;
+        };
+
+
+        // The entries are huffman::Entry, with the first code of each string in FirstBit
+        template<typename TEntryIndex, std::size_t CODES_LENGTH, std::size_t NUM_SYMBOLS>
+        struct Encoding
+        {
+            static constexpr std::size_t NumEntries = TEntryIndex::NumEntries;
+
+            using StringType = IterableString;
+
+            constexpr StringType operator[](std::size_t idx) const
+            {
+                // bounds check without exceptions
+                if(idx >= NumEntries)
+                    return bad_string();
+
+                // the codes end where the next string starts, or at the end of the codes for the last entry
+                auto const entry = m_Entries[idx];
+                std::size_t const nextStart = (idx < NumEntries - 1) ? m_Entries[idx + 1].FirstBit : CODES_LENGTH;
+
+                return StringType{std::span{m_Codes}.subspan(entry.FirstBit, nextStart - entry.FirstBit), entry.OriginalStringLength, symbols()};
+            }
+
+            // provide a value that is an implementation defined value representing a
+            // bad key or index was requested.
+            constexpr StringType bad_string() const {
+                // this is an empty string
+                return StringType{{}, 0, symbols()};
+            }
+
+            TEntryIndex m_Entries;
+            std::array<char, CODES_LENGTH> m_Codes;
+            std::array<SymbolBytes, NUM_SYMBOLS> m_SymbolBytes;
+            std::array<std::uint8_t, NUM_SYMBOLS> m_SymbolLengths;
+
+        private:
+            constexpr Symbols symbols() const
+            {
+                return Symbols{m_SymbolBytes, m_SymbolLengths};
+            }
+        };
+
+
+        // Encode a string with the longest symbol at each position, calling emit with each symbol index,
+        // or with table.Count for a character that has no symbol
+        constexpr void EncodeString(SymbolTable const &table, std::string_view str, auto emit)
+        {
+            for(std::size_t pos{0}; pos < str.size();) {
+                auto const idx = table.match(str, pos);
+                emit(idx, pos);
+                pos += idx < table.Count ? table.Symbols.at(idx).Length : 1;
+            }
+        }
+
+        // The bytes each symbol in the table takes to store, its padded characters and its length
+        constexpr std::size_t SymbolStorage = MaxSymbolLength + 1;
+
+        // The code bytes saved each time a symbol is used. A symbol of several characters saves a code for
+        // each character after the first, a single character symbol saves the escape it replaces.
+        constexpr std::size_t SavedPerUse(std::size_t length)
+        {
+            return length == 1 ? 1 : length - 1;
+        }
+
+        //
+        // Build the symbol table in rounds. Each round encodes the strings with the table so far and
+        // counts the symbols used, the characters under them, and each pair of adjacent symbols joined
+        // together. The next table is the candidates that would have saved the most bytes, after paying
+        // for their storage. Candidates that don't pay for themselves are left out.
+        //
+        template<Options OPTIONS, std::size_t TOTAL_LENGTH>
+        static constexpr auto BuildSymbolTable(CallableGivesIterableStringViews auto makeStringsLambda)
+        {
+            constexpr auto st = makeStringsLambda();
+
+            struct Candidate
+            {
+                std::size_t Gain;
+                Symbol::Key Sym;
+            };
+
+            SymbolTable table{};
+            std::array<Symbol::Key, 3 * TOTAL_LENGTH> found{};
+            std::array<Candidate, 3 * TOTAL_LENGTH> candidates{};
+
+            for(std::size_t round{0}; round < OPTIONS.Rounds; ++round) {
+                table.index();
+
+                std::size_t numFound{0};
+                for(std::string_view const str : st) {
+                    Symbol previous{};
+                    EncodeString(table, str, [&](std::size_t idx, std::size_t pos) {
+                        auto const single = Symbol::Single(str.at(pos));
+                        auto const current = idx < table.Count ? table.Symbols.at(idx) : single;
+
+                        found.at(numFound++) = current.key();
+                        if(current.Length > 1) {
+                            found.at(numFound++) = single.key();
+                        }
+                        if(previous.Length > 0 && previous.Length + current.Length <= MaxSymbolLength) {
+                            found.at(numFound++) = Symbol::Concat(previous, current).key();
+                        }
+                        previous = current;
+                    });
+                }
+                std::sort(found.begin(), found.begin() + static_cast<std::ptrdiff_t>(numFound));
+
+                // the gain of a symbol is the code bytes it saved less the bytes to store it
+                std::size_t numCandidates{0};
+                for(std::size_t i{0}; i < numFound;) {
+                    auto j = i;
+                    while(j < numFound && found.at(j) == found.at(i)) {
+                        ++j;
+                    }
+                    auto const saved = (j - i) * SavedPerUse(found.at(i).Length);
+                    if(saved > SymbolStorage) {
+                        candidates.at(numCandidates++) = Candidate{saved - SymbolStorage, found.at(i)};
+                    }
+                    i = j;
+                }
+
+                std::sort(candidates.begin(), candidates.begin() + static_cast<std::ptrdiff_t>(numCandidates), [](auto const &a, auto const &b) {
+                    return a.Gain != b.Gain ? a.Gain > b.Gain : a.Sym < b.Sym;
+                });
+
+                table.Count = std::min({numCandidates, OPTIONS.MaxSymbols, table.Symbols.size()});
+                for(std::size_t i{0}; i < table.Count; ++i) {
+                    table.Symbols.at(i) = Symbol::FromKey(candidates.at(i).Sym);
+                }
+            }
+
+            table.index();
+            return table;
+        }
+
+
+        template<Options OPTIONS = Options{}>
+        static constexpr auto MakeEncoding(CallableGivesIterableStringViews auto makeStringsLambda)
+        {
+            static_assert(OPTIONS.MaxSymbols <= 255, "There can be no more than 255 symbols, the last code is the escape");
+
+            // get the string table to work with
+            constexpr auto st = makeStringsLambda();
+            constexpr auto NumStrings = static_cast<std::size_t>(std::distance(st.begin(), st.end()));
+            constexpr auto TotalLength = std::accumulate(
+                    st.begin(), st.end(), std::size_t{0},
+                    [](auto total, auto const &sv){ return total + sv.size(); });
+            constexpr auto MaxStringLength = std::accumulate(
+                    st.begin(), st.end(), std::size_t{0},
+                    [](std::size_t longest, auto const &sv){ return std::max(longest, sv.size()); });
+
+            constexpr auto table = BuildSymbolTable<OPTIONS, TotalLength>(makeStringsLambda);
+
+            // only the symbols that are used are stored, numbered in the order they are in the table
+            constexpr auto codes = [=]() {
+                std::array<std::size_t, 256> result{};
+                std::array<bool, 255> used{};
+                for(std::string_view const str : st) {
+                    EncodeString(table, str, [&](std::size_t idx, std::size_t) {
+                        if(idx < table.Count) {
+                            used.at(idx) = true;
+                        }
+                    });
+                }
+
+                std::size_t next{0};
+                for(std::size_t i{0}; i < table.Count; ++i) {
+                    result.at(i) = used.at(i) ? next++ : Escape;
+                }
+                result.at(255) = next;
+                return result;
+            }();
+            constexpr auto NumSymbols = codes.at(255);
+
+            constexpr auto CodesLength = [=]() {
+                std::size_t length{0};
+                for(std::string_view const str : st) {
+                    EncodeString(table, str, [&](std::size_t idx, std::size_t) {
+                        length += idx < table.Count ? 1 : 2;
+                    });
+                }
+                return length;
+            }();
+
+            using EntryIndexType = huffman::EntryIndex<NumStrings, CodesLength, MaxStringLength>;
+            Encoding<EntryIndexType, CodesLength, NumSymbols> result{};
+
+            for(std::size_t i{0}; i < table.Count; ++i) {
+                if(codes.at(i) != Escape) {
+                    result.m_SymbolBytes.at(codes.at(i)) = table.Symbols.at(i).Bytes;
+                    result.m_SymbolLengths.at(codes.at(i)) = static_cast<std::uint8_t>(table.Symbols.at(i).Length);
+                }
+            }
+
+            std::size_t out{0};
+            std::size_t s{0};
+            for(std::string_view const str : st) {
+                result.m_Entries.set(s++, huffman::Entry{out, str.size()});
+                EncodeString(table, str, [&](std::size_t idx, std::size_t pos) {
+                    if(idx < table.Count) {
+                        result.m_Codes.at(out++) = static_cast<char>(codes.at(idx));
+                    } else {
+                        result.m_Codes.at(out++) = static_cast<char>(Escape);
+                        result.m_Codes.at(out++) = str.at(pos);
+                    }
+                });
+            }
+
+            return result;
+        }
+    }
+
+    template<fsst::Options OPTIONS = fsst::Options{}>
+    class BasicFsstEncoder
+    {
+    public:
+
+        // Tables the symbol table can't shrink, such as a few lines of text with little repeated, are stored
+        // uncompressed instead, as every character without a symbol takes an escape as well as itself.
+        static constexpr auto Compile(CallableGivesIterableStringViews auto makeStringsLambda)
+        {
+            constexpr auto const encoding = fsst::MakeEncoding<OPTIONS>(makeStringsLambda);
+            constexpr auto const uncompressed = NilEncoder::Compile(makeStringsLambda);
+
+            if constexpr (sizeof(encoding) <= sizeof(uncompressed)) {
+                return encoding;
+            } else {
+                return uncompressed;
+            }
+        }
+    };
+
+    // A static symbol table of up to 255 symbols of 1 to 8 characters, each string stored as one byte codes.
+    // Falls back to NilEncoder for tables that don't compress.
+    using FsstEncoder = BasicFsstEncoder<>;
+
+}
+
+#endif //SQUEEZE_FSSTENCODER_H
@@ -3,20 +3,113 @@
 
 #include <limits>
 #include <algorithm>
+#include <numeric>
 #include <array>
 #include <utility>
-#include <variant>
 #include <span>
 
 #include "concepts.h"
 #include "lib/priority_queue.h"
 #include "lib/list.h"
 #include "lib/bit_stream.h"
+#include "lib/bit_reader.h"
+#include "lib/smallest_uint.h"
+#include "lib/elias_fano.h"
+#include "lib/suffix_owners.h"
 
 namespace squeeze {
 
     namespace huffman {
 
+        // Selects how strings are decoded
+        enum class DecodeMode
+        {
+            // Strings access the bit stream through a type-erased function, so the decoder is shared
+            // between all tables in an application. Smallest code size.
+            Compact,
+            // Strings read the bytes of the bit stream directly through a local bit buffer. The decoder
+            // can be inlined at the point of use. Fastest decode.
+            Fast
+        };
+
+        // Selects how the start and length of each string is stored
+        enum class IndexMode
+        {
+            // Arrays of the narrowest integers that fit. Fastest access.
+            Dense,
+            // Start bits are Elias-Fano coded and lengths are bit packed. Much smaller for tables of
+            // many short strings, at the cost of a short scan to locate each string.
+            EliasFano
+        };
+
+        // Compile time options controlling how a HuffmanEncoder builds its encoding
+        struct Options
+        {
+            // Number of bits used to index the decode lookup table. Each lookup decodes a whole
+            // character if its code fits in this many bits, otherwise it moves part way down the tree
+            // and decoding continues one bit at a time from there. The table has 2^LookupBits entries,
+            // so this trades flash for decode speed. 0 disables the table.
+            std::size_t LookupBits{0};
+
+            // When non-zero, canonical Huffman codes are generated with lengths limited to this
+            // many bits. The decoder then only needs the list of symbols and the number of codes of
+            // each length rather than the whole tree, and a whole code can be fetched with a single
+            // peek of MaxCodeLength bits. 0 stores and walks the tree.
+            std::size_t MaxCodeLength{0};
+
+            // How strings from the table are decoded. This does not change the encoded data.
+            DecodeMode Decoder{DecodeMode::Compact};
+
+            // Strings of at least this many characters are split into InterleaveStreams sub-streams, with
+            // character i stored in sub-stream i % InterleaveStreams. The sub-streams can be decoded
+            // independently, so bulk decoding works on all of them at once. Each interleaved string
+            // stores the lengths of its sub-streams. 0 disables interleaving.
+            std::size_t InterleaveThreshold{0};
+            std::size_t InterleaveStreams{4};
+
+            // How the start and length of each string is stored. This does not change the encoded data.
+            IndexMode Index{IndexMode::Dense};
+
+            // Strings of at least CheckpointThreshold characters store where decoding can restart every
+            // CheckpointInterval characters. at(), substr() and iterator advance then decode from the nearest
+            // checkpoint rather than the start of the string. Each checkpoint costs an offset per sub-stream,
+            // so a longer interval trades access time for size. An interval of 0 disables checkpoints.
+            // If strings are interleaved, the interval must be a multiple of InterleaveStreams.
+            std::size_t CheckpointInterval{0};
+            std::size_t CheckpointThreshold{0};
+        };
+
+        // determine if a string of the given length is split into interleaved sub-streams
+        constexpr bool IsInterleaved(Options const &options, std::size_t stringLength)
+        {
+            return options.InterleaveThreshold != 0 && stringLength >= options.InterleaveThreshold;
+        }
+
+        // the number of sub-streams a string of the given length is stored in
+        constexpr std::size_t StreamCount(Options const &options, std::size_t stringLength)
+        {
+            return IsInterleaved(options, stringLength) ? options.InterleaveStreams : 1;
+        }
+
+        // the number of checkpoints stored for a string of the given length. There is one every
+        // CheckpointInterval characters, not counting the start of the string.
+        constexpr std::size_t NumCheckpoints(Options const &options, std::size_t stringLength)
+        {
+            if(options.CheckpointInterval == 0 || stringLength == 0 || stringLength < options.CheckpointThreshold) {
+                return 0;
+            }
+
+            return (stringLength - 1) / options.CheckpointInterval;
+        }
+
+        // the number of offsets stored at the start of a string: the length of each sub-stream but the last,
+        // followed by the offset into each sub-stream for every checkpoint.
+        constexpr std::size_t NumHeaderOffsets(Options const &options, std::size_t stringLength)
+        {
+            auto const streams = StreamCount(options, stringLength);
+            return (streams - 1) + NumCheckpoints(options, stringLength) * streams;
+        }
+
         // Used to count character frequency in source strings
         struct CharFrequency {
             char c;
@@ -48,6 +141,9 @@ namespace squeeze {
         };
 
         // Used to store the huffman tree in a flat array.
+        //
+        // A node is a pair of 16 bit links. A leaf stores its character in the zero link, marked with
+        // LeafTag, so testing for a leaf or following a link is a single load and mask.
         struct Node
         {
         public:
@@ -58,39 +154,45 @@ namespace squeeze {
             using CharType = char;
             using Links = std::array<IndexType, 2>; // [zeroLink, oneLink]
 
-            // if index returns this, it is out of bounds.
-            static constexpr IndexType BadIndex = std::numeric_limits<IndexType>::max();
+            // set in a link that holds a character rather than a node index
+            static constexpr IndexType LeafTag = IndexType{1} << (std::numeric_limits<IndexType>::digits - 1);
+
+            // if index returns this, it is out of bounds. Kept clear of LeafTag so an unset link is not a leaf.
+            static constexpr IndexType BadIndex = LeafTag - 1;
+
+            // make a link holding a character
+            static constexpr IndexType LeafLink(char c)
+            {
+                return static_cast<IndexType>(LeafTag | static_cast<unsigned char>(c));
+            }
+
+            static constexpr bool IsLeafLink(IndexType link) { return (link & LeafTag) != 0; }
+
+            static constexpr CharType LinkValue(IndexType link) { return static_cast<CharType>(link & 0xFFu); }
 
             constexpr Node() = default; // needed to construct array before initialisation
 
             // Make a leaf node
             constexpr explicit Node(char c)
-                : m_Data{c}
+                : m_Links{LeafLink(c), BadIndex}
             {}
 
             // Make an intermediate node
             constexpr Node(IndexType zero, IndexType one)
-                : m_Data{std::to_array({zero, one})}
+                : m_Links{zero, one}
             {}
 
-            [[nodiscard]] constexpr bool is_leaf() const { return std::holds_alternative<char>(m_Data); }
+            [[nodiscard]] constexpr bool is_leaf() const { return IsLeafLink(m_Links[0]); }
 
-            [[nodiscard]] constexpr CharType value() const { return std::get<char>(m_Data); }
+            [[nodiscard]] constexpr CharType value() const { return LinkValue(m_Links[0]); }
 
             [[nodiscard]] constexpr IndexType operator[](std::size_t idx) const
             {
-                // NOTE: we are using the non-throwing interface for variants in order to
-                // make the code workable in embedded/small targets without exception support
-                const auto *ptr = std::get_if<Links>(&m_Data);
-                if (ptr != nullptr) {
-                    return ptr->at(idx);
-                }
-
-                return BadIndex;
+                return is_leaf() ? BadIndex : m_Links.at(idx);
             }
 
         private:
-            std::variant<char, Links> m_Data;
+            Links m_Links{BadIndex, BadIndex};
         };
 
         // we need to know the parent of a node to perform encoding efficiently
@@ -118,6 +220,175 @@ namespace squeeze {
             IndexType m_ParentIndex;
         };
 
+        // An entry in the decode lookup table, indexed by the next LookupBits bits of the stream
+        // (first bit in the least significant position)
+        struct LookupEntry
+        {
+            // if IsLeaf, the character decoded, otherwise the intermediate node index to continue decoding from.
+            // Canonical codes always continue from the start of the code.
+            Node::IndexType Value;
+            // number of bits consumed from the stream by this lookup
+            std::uint8_t Length;
+            bool IsLeaf;
+        };
+
+        // the number of entries in a decode lookup table indexed by the given number of bits
+        constexpr std::size_t LookupTableSize(std::size_t lookupBits)
+        {
+            return lookupBits == 0 ? 0 : std::size_t{1} << lookupBits;
+        }
+
+        //
+        // A non-templated view of the tables needed to decode characters from a bit stream.
+        //
+        // Either the packed tree is walked a bit at a time, or canonical codes are decoded using
+        // the symbols (ordered by code) and the number of codes of each length. A lookup table
+        // may be present to short cut either.
+        //
+        struct CodeBook
+        {
+            std::array<std::span<Node::IndexType const>, 2> Links;      // [zeroLinks, oneLinks] of each intermediate node
+            Node::IndexType Root{Node::LeafLink('\0')};                 // link to the root of the tree
+            std::span<char const> Symbols;
+            std::span<std::uint16_t const> LengthCounts;    // indexed by code length, so [0] is unused
+            std::span<LookupEntry const> Lookup;
+            std::size_t LookupBits{0};
+
+            // Decode the next character from the reader, consuming its code.
+            // The reader must provide peek(count) and consume(count), for counts up to 32 bits.
+            template<typename TReader>
+            [[nodiscard]] constexpr char decode(TReader &reader) const
+            {
+                auto link = Root;
+
+                // if we have a lookup table, use it to decode as many bits as possible in one step.
+                // This either gives us the character, or a node part way down the tree to continue from
+                if(!Lookup.empty()) {
+                    auto const &entry = Lookup[static_cast<std::size_t>(reader.peek(LookupBits))];
+
+                    reader.consume(entry.Length);
+                    if(entry.IsLeaf) {
+                        return static_cast<char>(entry.Value);
+                    }
+
+                    link = entry.Value;
+                }
+
+                if(!Symbols.empty()) {
+                    return decode_canonical(reader);
+                }
+
+                // walk the tree using the bit stream until we follow a link to a leaf.
+                // Then return the character it holds
+                while(!Node::IsLeafLink(link)) {
+                    link = Links[static_cast<std::size_t>(reader.peek(1))][link];
+                    reader.consume(1);
+                }
+
+                return Node::LinkValue(link);
+            }
+
+            // true if the codes are canonical with a lookup table, so decode_buffered() can be used
+            [[nodiscard]] constexpr bool can_decode_buffered() const { return !Lookup.empty() && !Symbols.empty(); }
+
+            // the length of the longest canonical code
+            [[nodiscard]] constexpr std::size_t max_code_length() const { return LengthCounts.size() - 1; }
+
+            // Decode the next character from a lib::bit_reader that already holds max_code_length() bits.
+            // A code that fits the lookup table is a single load and consume, with no refill check. Longer
+            // codes are left to decode(), so this stays small enough to inline into the decode loop.
+            // Only for code books where can_decode_buffered().
+            [[nodiscard]] constexpr char decode_buffered(lib::bit_reader &reader) const
+            {
+                auto const &entry = Lookup[static_cast<std::size_t>(reader.peek_buffered(LookupBits))];
+                if(entry.IsLeaf) {
+                    reader.consume(entry.Length);
+                    return static_cast<char>(entry.Value);
+                }
+
+                return decode(reader);
+            }
+
+        private:
+            template<typename TReader>
+            [[nodiscard]] constexpr char decode_canonical(TReader &reader) const
+            {
+                // fetch enough bits for the longest code, then extend the code a bit at a time until
+                // it falls in the range of codes of that length. Codes are stored most significant bit first.
+                auto const maxLength = LengthCounts.size() - 1;
+                auto const bits = reader.peek(maxLength);
+
+                std::uint64_t code{0};    // code read so far
+                std::uint64_t first{0};   // first code of the current length
+                std::size_t index{0};     // index of the first symbol of the current length
+
+                for(std::size_t len{1}; len <= maxLength; ++len) {
+                    code |= (bits >> (len - 1)) & 1u;
+
+                    auto const count = LengthCounts[len];
+                    if(code < first + count) {
+                        reader.consume(len);
+                        return Symbols[index + (code - first)];
+                    }
+
+                    index += count;
+                    first = (first + count) << 1;
+                    code <<= 1;
+                }
+
+                // bad encoding, see above
+                reader.consume(maxLength);
+                return '\0';
+            }
+        };
+
+        // The decode tables for a Huffman tree. Only the intermediate nodes are stored, as arrays of their
+        // zero and one links. Leaves are folded into the links of their parents.
+        template<std::size_t NUM_TREE_NODES, std::size_t LOOKUP_BITS>
+        struct TreeTables
+        {
+            static constexpr std::size_t NumTreeNodes = NUM_TREE_NODES;
+            // a full binary tree has one less intermediate node than leaves
+            static constexpr std::size_t NumIntermediateNodes = NUM_TREE_NODES / 2;
+            static constexpr std::size_t LookupBits = LOOKUP_BITS;
+
+            [[nodiscard]] constexpr CodeBook code_book() const
+            {
+                return CodeBook{ {std::span{m_Links[0]}, std::span{m_Links[1]}}, m_Root, {}, {}, std::span{m_Lookup}, LookupBits };
+            }
+
+            std::array<std::array<Node::IndexType, NumIntermediateNodes>, 2> m_Links;
+            Node::IndexType m_Root;
+            [[no_unique_address]] std::array<LookupEntry, LookupTableSize(LOOKUP_BITS)> m_Lookup;
+        };
+
+        // The decode tables for canonical codes, which are fully described by the symbols in code
+        // order and the number of codes of each length.
+        template<std::size_t NUM_SYMBOLS, std::size_t MAX_CODE_LENGTH, std::size_t LOOKUP_BITS>
+        struct CanonicalTables
+        {
+            static constexpr std::size_t NumSymbols = NUM_SYMBOLS;
+            static constexpr std::size_t MaxCodeLength = MAX_CODE_LENGTH;
+            static constexpr std::size_t LookupBits = LOOKUP_BITS;
+
+            [[nodiscard]] constexpr CodeBook code_book() const
+            {
+                return CodeBook{ {}, Node::LeafLink('\0'), std::span{m_Symbols}, std::span{m_LengthCounts}, std::span{m_Lookup}, LookupBits };
+            }
+
+            std::array<char, NUM_SYMBOLS> m_Symbols;
+            std::array<std::uint16_t, MAX_CODE_LENGTH + 1> m_LengthCounts;
+            [[no_unique_address]] std::array<LookupEntry, LookupTableSize(LOOKUP_BITS)> m_Lookup;
+        };
+
+        // The code used to encode a character. The bits are stored in the order they are written to
+        // the stream, so they can be copied out in bulk.
+        struct CharCode
+        {
+            std::size_t BitLength{0};
+            lib::bit_stream<256> Bits{};    // worst case imaginable :)
+        };
+
         // Encodes the start bit and original length of a compressed string
         struct Entry
         {
@@ -125,16 +396,171 @@ namespace squeeze {
             std::size_t OriginalStringLength;
         };
 
+        // The Entry for each compressed string. The fields are stored in separate arrays, each using the
+        // narrowest unsigned type that holds its largest value, so there is no padding between them.
+        template<std::size_t NUM_ENTRIES, std::size_t MAX_FIRST_BIT, std::size_t MAX_STRING_LENGTH>
+        class EntryIndex
+        {
+        public:
+            static constexpr std::size_t NumEntries = NUM_ENTRIES;
+            using FirstBitType = lib::smallest_uint_t<MAX_FIRST_BIT>;
+            using LengthType = lib::smallest_uint_t<MAX_STRING_LENGTH>;
+
+            constexpr Entry operator[](std::size_t idx) const
+            {
+                return Entry{ m_FirstBits[idx], m_Lengths[idx] };
+            }
+
+            constexpr void set(std::size_t idx, Entry const &entry)
+            {
+                m_FirstBits.at(idx) = static_cast<FirstBitType>(entry.FirstBit);
+                m_Lengths.at(idx) = static_cast<LengthType>(entry.OriginalStringLength);
+            }
+
+        private:
+            std::array<FirstBitType, NUM_ENTRIES> m_FirstBits;
+            std::array<LengthType, NUM_ENTRIES> m_Lengths;
+        };
+
+        // The Entry for each compressed string, with the first bits Elias-Fano coded (they never decrease)
+        // and the lengths packed into just enough bits for the longest string.
+        template<std::size_t NUM_ENTRIES, std::size_t MAX_FIRST_BIT, std::size_t MAX_STRING_LENGTH>
+        class EliasFanoEntryIndex
+        {
+        public:
+            static constexpr std::size_t NumEntries = NUM_ENTRIES;
+            static constexpr std::size_t LengthBits = lib::bits_needed(MAX_STRING_LENGTH);
+
+            constexpr Entry operator[](std::size_t idx) const
+            {
+                return Entry{ m_FirstBits[idx], m_Lengths.peek(idx * LengthBits, LengthBits) };
+            }
+
+            // entries must be set in index order
+            constexpr void set(std::size_t idx, Entry const &entry)
+            {
+                m_FirstBits.set(idx, entry.FirstBit);
+                m_Lengths.write(idx * LengthBits, entry.OriginalStringLength, LengthBits);
+            }
+
+        private:
+            lib::elias_fano<NUM_ENTRIES, MAX_FIRST_BIT> m_FirstBits;
+            lib::bit_stream<NUM_ENTRIES * LengthBits> m_Lengths;
+        };
+
+        // select the type of entry index for the index mode
+        template<IndexMode INDEX_MODE, std::size_t NUM_ENTRIES, std::size_t MAX_FIRST_BIT, std::size_t MAX_STRING_LENGTH>
+        using EntryIndexType = std::conditional_t<INDEX_MODE == IndexMode::EliasFano,
+            EliasFanoEntryIndex<NUM_ENTRIES, MAX_FIRST_BIT, MAX_STRING_LENGTH>,
+            EntryIndex<NUM_ENTRIES, MAX_FIRST_BIT, MAX_STRING_LENGTH>>;
+
+
+        // the most sub-streams a long string can be interleaved into
+        constexpr std::size_t MaxInterleavedStreams = 4;
+
+        // The start bit of each independently decodable sub-stream of a string. Character i of the
+        // string is stored in sub-stream i % Count. Strings that are not interleaved have one stream.
+        struct StreamStarts
+        {
+            std::array<std::size_t, MaxInterleavedStreams> FirstBit{};
+            std::size_t Count{1};
+        };
+
+        // Where decoding of a string can restart part way through. For each of Count checkpoints, every
+        // Interval characters, there is the offset from the start of each sub-stream to the next character
+        // in it, each OffsetBits long and starting at FirstBit.
+        struct Checkpoints
+        {
+            std::size_t FirstBit{0};
+            std::size_t Count{0};
+            std::size_t Interval{0};
+            std::size_t OffsetBits{0};
+        };
+
+
+        // Reads the bits of a compressed stream through a type-erased accessor, so we don't have to
+        // template the decoder on the bitstream size, and one copy of it serves every table.
+        class ErasedBitSource
+        {
+        public:
+            // Fetches a number of bits starting at an absolute bit index, first bit in the least significant
+            // position. Bits past the end of the stream read as zero.
+            using BitsAccessorFunc = std::uint64_t(*)(std::size_t, std::size_t, const void *);
+
+            // reads the bits for the CodeBook from a position in the stream
+            class Reader
+            {
+            public:
+                constexpr Reader() = default;
+                constexpr Reader(ErasedBitSource const &source, std::size_t bit) : m_Source{&source}, m_Bit{bit} {}
+
+                [[nodiscard]] constexpr std::uint64_t peek(std::size_t count) const { return m_Source->peek(m_Bit, count); }
+                constexpr void consume(std::size_t count) { m_Bit += count; }
+
+            private:
+                ErasedBitSource const *m_Source{nullptr};
+                std::size_t m_Bit{0};
+            };
+
+            constexpr ErasedBitSource(const void *compressedStream, BitsAccessorFunc peekBits)
+                : m_compressedStream{compressedStream}
+                , m_PeekBits{std::move(peekBits)}
+            {}
+
+            [[nodiscard]] constexpr Reader reader(std::size_t firstBit) const { return Reader{*this, firstBit}; }
+
+            [[nodiscard]] constexpr std::uint64_t peek(std::size_t bit, std::size_t count) const
+            {
+                return m_PeekBits(bit, count, m_compressedStream);
+            }
+
+        private:
+            void const * m_compressedStream;
+            BitsAccessorFunc m_PeekBits;
+        };
+
+        // Reads the bytes of a compressed stream directly, through a local bit buffer. There are no
+        // type-erased calls, so the decoder can be inlined and optimised where the string is used.
+        class ByteBitSource
+        {
+        public:
+            using Reader = lib::bit_reader;
+
+            constexpr explicit ByteBitSource(std::span<std::uint8_t const> stream) : m_Stream{stream} {}
+
+            [[nodiscard]] constexpr Reader reader(std::size_t firstBit) const { return Reader{m_Stream, firstBit}; }
+
+            [[nodiscard]] constexpr std::uint64_t peek(std::size_t bit, std::size_t count) const
+            {
+                return reader(bit).peek(count);
+            }
+
+        private:
+            std::span<std::uint8_t const> m_Stream;
+        };
+
 
         // Represents a string that is being accessed. We have to do this via iteration,
         // so we don't have to build the entire string in memory before using it - this would
         // make compressing it pointless in a memory constrained environment.
         //
-        // Note: we don't template this object and handle data as spans so that we have to have
-        // multiple copies of this code if more than one string table is defined in an application
-        struct IterableString
+        // Note: we don't template this object on the table, and handle data as spans so that we don't have to
+        // have multiple copies of this code if more than one string table is defined in an application.
+        // It is only templated on how the bits are read, see IterableString and FastIterableString.
+        template<typename TBitSource>
+        class BasicIterableString
         {
         private:
+            using Reader = typename TBitSource::Reader;
+            using Readers = std::array<Reader, MaxInterleavedStreams>;
+
+            // the decode position in each sub-stream, and the sub-stream holding the next character
+            struct Cursor
+            {
+                Readers Streams{};
+                std::size_t Stream{0};
+            };
+
             class ValueHolder
             {
             public:
@@ -147,10 +573,6 @@ namespace squeeze {
             };
 
         public:
-            // provide a type-erased method to access the bits from a bitstream without having
-            // to template the IterableString on the bitstream size.
-            using BitAccessorFunc = bool(*)(std::size_t, std::size_t, const void *);   // index 0 = first bit in encoded string
-
             class Iterator
             {
             public:
@@ -160,21 +582,17 @@ namespace squeeze {
                 using pointer = char const *;
                 using difference_type = void;
 
-                struct EndPosition{IterableString const &str;};
+                struct EndPosition{BasicIterableString const &str;};
 
                 // used to construct a begin iterator
-                constexpr explicit Iterator(IterableString const &owner)
+                constexpr explicit Iterator(BasicIterableString const &owner)
                     : m_Owner{owner}
                     , m_CharPosition{0}
                 {
-                    // handle empty string
-                    if(m_Owner.m_StringLength == 0) {
-                        // turn into end iterator
-                        m_CharPosition = m_Owner.m_StringLength;
-                    } else {
-                        // load the first character
-                        next();
-                        m_CharPosition = 0;
+                    // load the first character, an empty string is already the end iterator
+                    if(!is_done()) {
+                        m_Cursor = owner.seek(owner.m_First);
+                        decode();
                     }
                 }
 
@@ -193,10 +611,13 @@ namespace squeeze {
                 }
 
                 constexpr Iterator &operator++() {
-                    // NOTE: we don't check for end of iteration here, but next() will
-                    // do something sensible. Just expect weird if you run off the end of
+                    // we can only fetch up to the last character, but need to increment past end
+                    // for end iterator comparison. Just expect weird if you run off the end of
                     // the string
-                    next();
+                    ++m_CharPosition;
+                    if(!is_done()) {
+                        decode();
+                    }
                     return *this;
                 }
 
@@ -206,6 +627,32 @@ namespace squeeze {
                     return temp;
                 }
 
+                // Advance n characters. If the string has a checkpoint past the next character and no
+                // further than the target, decoding restarts from it rather than decoding every character.
+                constexpr Iterator &operator+=(std::size_t n) {
+                    if(n == 0 || is_done()) {
+                        return *this;
+                    }
+
+                    auto const target = m_CharPosition + n;
+                    if(target >= m_Owner.m_StringLength) {
+                        m_CharPosition = m_Owner.m_StringLength;
+                        return *this;
+                    }
+
+                    // the cursor is at the character after the current one
+                    auto const next = m_Owner.m_First + m_CharPosition + 1;
+                    if(m_Owner.checkpoint_before(m_Owner.m_First + target) > next) {
+                        m_Cursor = m_Owner.seek(m_Owner.m_First + target);
+                    } else {
+                        m_Owner.skip(m_Cursor, m_Owner.m_First + target - next);
+                    }
+
+                    m_CharPosition = target;
+                    decode();
+                    return *this;
+                }
+
                 constexpr friend bool operator==(Iterator const &lhs, Iterator const &rhs) {
                     return lhs.m_CharPosition == rhs.m_CharPosition;
                 }
@@ -216,124 +663,302 @@ namespace squeeze {
                     return m_CharPosition >= m_Owner.m_StringLength;
                 }
 
-                constexpr void next()
+                // decode the next character into m_Current
+                constexpr void decode()
                 {
-                    // we can only fetch up to the last character, but need to increment past end
-                    // for end iterator comparison
-                    if(m_CharPosition + 1 < m_Owner.m_StringLength) {
-                        std::size_t i{0};    // start at root node
-
-                        // walk the node tree using the bit stream until we get to a leaf node.
-                        // Then return the character encoded by that node
-                        while(!m_Owner.m_Nodes[i].is_leaf()) {
-                            auto bit = m_Owner.m_GetBit(m_Owner.m_firstBit, m_NextBit++, m_Owner.m_compressedStream);
-                            i = m_Owner.m_Nodes[i][static_cast<std::size_t>(bit)];
-
-                            if(i == Node::BadIndex) {
-                                // this is an error that indicates the encoding is incorrect.
-                                // We don't want to involve exceptions so we can support
-                                // embedded/small targets with exceptions disabled.
-                                // Best we can do here in this unlikely scenario
-                                m_Current = '\0';
-                                ++m_CharPosition;
-                                return;
-                            }
-                        }
-
-                        m_Current = m_Owner.m_Nodes[i].value();
-                    }
-
-                    ++m_CharPosition;
+                    m_Current = m_Owner.next(m_Cursor);
                 }
 
-                IterableString const &m_Owner;
+                BasicIterableString const &m_Owner;
 
                 // iteration state
+                Cursor m_Cursor{};
                 char m_Current{0};
-                std::size_t m_NextBit{0};
                 std::size_t m_CharPosition{0};
-
             };
 
-            constexpr IterableString(
-                    std::size_t firstBit,
+            constexpr BasicIterableString(
+                    StreamStarts starts,
                     std::size_t stringLength,
-                    const void *compressedStream,
-                    BitAccessorFunc getBit,
-                    std::span<Node const> nodes
+                    TBitSource source,
+                    CodeBook codeBook,
+                    Checkpoints checkpoints = {},
+                    std::size_t first = 0
             )
-                : m_firstBit{firstBit}
+                : m_Starts{starts}
+                , m_Checkpoints{checkpoints}
+                , m_First{first}
                 , m_StringLength{stringLength}
-                , m_compressedStream{compressedStream}
-                , m_GetBit{std::move(getBit)}
-                , m_Nodes{nodes}
+                , m_Source{source}
+                , m_CodeBook{codeBook}
             {}
 
             [[nodiscard]] constexpr std::size_t size() const { return m_StringLength; }
 
             [[nodiscard]] constexpr Iterator begin() const { return Iterator{*this}; }
-            [[nodiscard]] constexpr Iterator end() const { return Iterator{Iterator::EndPosition{*this}}; }
+            [[nodiscard]] constexpr Iterator end() const { return Iterator{typename Iterator::EndPosition{*this}}; }
+
+            // Get the character at idx, decoding from the nearest checkpoint before it.
+            // Gives '\0' if idx is out of range.
+            [[nodiscard]] constexpr char at(std::size_t idx) const
+            {
+                if(idx >= m_StringLength) {
+                    return '\0';
+                }
+
+                auto cursor = seek(m_First + idx);
+                return next(cursor);
+            }
+
+            // Get the part of the string starting at pos, of up to count characters. Nothing is decoded
+            // until the substring is used, which starts from the nearest checkpoint before pos.
+            [[nodiscard]] constexpr BasicIterableString substr(std::size_t pos, std::size_t count = std::numeric_limits<std::size_t>::max()) const
+            {
+                pos = std::min(pos, m_StringLength);
+                count = std::min(count, m_StringLength - pos);
+
+                return BasicIterableString{m_Starts, count, m_Source, m_CodeBook, m_Checkpoints, m_First + pos};
+            }
+
+            // Decode the string into dest, stopping early if dest is too small.
+            // Returns the number of characters written.
+            constexpr std::size_t decode_into(std::span<char> dest) const
+            {
+                return decode_n(dest.begin(), std::min(dest.size(), m_StringLength));
+            }
+
+            // Decode the whole string to the output iterator. Returns the number of characters written.
+            template<typename TOutputIt>
+            constexpr std::size_t copy_to(TOutputIt out) const
+            {
+                return decode_n(out, m_StringLength);
+            }
 
         private:
-            std::size_t const m_firstBit;
+            // decode the next character at the cursor, taking characters from each sub-stream in turn
+            constexpr char next(Cursor &cursor) const
+            {
+                auto const c = m_CodeBook.decode(cursor.Streams[cursor.Stream]);
+                if(++cursor.Stream == m_Starts.Count) {
+                    cursor.Stream = 0;
+                }
+                return c;
+            }
+
+            // move the cursor past count characters
+            constexpr void skip(Cursor &cursor, std::size_t count) const
+            {
+                for(; count > 0; --count) {
+                    static_cast<void>(next(cursor));
+                }
+            }
+
+            // the position of the last checkpoint at or before position, counted from the start of
+            // the stored string. The start of the string is always a checkpoint.
+            [[nodiscard]] constexpr std::size_t checkpoint_before(std::size_t position) const
+            {
+                if(m_Checkpoints.Interval == 0) {
+                    return 0;
+                }
+
+                return std::min(position / m_Checkpoints.Interval, m_Checkpoints.Count) * m_Checkpoints.Interval;
+            }
+
+            // make a cursor for the character at position, counted from the start of the stored string
+            [[nodiscard]] constexpr Cursor seek(std::size_t position) const
+            {
+                auto const checkpoint = checkpoint_before(position);
+
+                Cursor cursor{};
+                for(std::size_t i{0}; i < m_Starts.Count; ++i) {
+                    auto bit = m_Starts.FirstBit[i];
+
+                    if(checkpoint != 0) {
+                        auto const offsetIndex = (checkpoint / m_Checkpoints.Interval - 1) * m_Starts.Count + i;
+                        bit += m_Source.peek(m_Checkpoints.FirstBit + offsetIndex * m_Checkpoints.OffsetBits, m_Checkpoints.OffsetBits);
+                    }
+
+                    cursor.Streams[i] = m_Source.reader(bit);
+                }
+
+                // checkpoints are always at a character in the first sub-stream
+                skip(cursor, position - checkpoint);
+                return cursor;
+            }
+
+            // decode the first count characters of the string to out
+            template<typename TOutputIt>
+            constexpr std::size_t decode_n(TOutputIt out, std::size_t count) const
+            {
+                auto cursor = seek(m_First);
+
+                // decode single characters until the next one is in the first sub-stream
+                std::size_t done{0};
+                for(; done < count && cursor.Stream != 0; ++done) {
+                    *out++ = next(cursor);
+                }
+
+                // select a decode loop with the number of streams known, so each loop step decodes
+                // one character from every stream with no dependency between them
+                switch(m_Starts.Count) {
+                    case 2: decode_interleaved<2>(cursor.Streams, out, count - done); break;
+                    case 3: decode_interleaved<3>(cursor.Streams, out, count - done); break;
+                    case 4: decode_interleaved<4>(cursor.Streams, out, count - done); break;
+                    default: decode_interleaved<1>(cursor.Streams, out, count - done); break;
+                }
+
+                return count;
+            }
+
+            template<std::size_t NUM_STREAMS, typename TOutputIt>
+            constexpr void decode_interleaved(Readers const &readers, TOutputIt out, std::size_t count) const
+            {
+                // work on local copies, including the output iterator, so writes to the output can't alias the decoder state
+                auto const codeBook = m_CodeBook;
+                std::array<Reader, NUM_STREAMS> local{};
+                std::copy_n(readers.begin(), NUM_STREAMS, local.begin());
+
+                std::size_t i{0};
+
+                if constexpr (std::is_same_v<Reader, lib::bit_reader>) {
+                    // refill each stream once for several characters, then take each character with a
+                    // single table load. The streams don't depend on each other, so their loads overlap.
+                    constexpr std::size_t PerRefill = 4;
+                    constexpr std::size_t PerStep = NUM_STREAMS * PerRefill;
+                    auto const refillBits = PerRefill * codeBook.max_code_length();
+
+                    if(codeBook.can_decode_buffered() && refillBits <= lib::bit_reader::MaxPeekBits) {
+                        for(; i + PerStep <= count; i += PerStep) {
+                            for(auto &reader : local) {
+                                reader.ensure(refillBits);
+                            }
+
+                            // unrolled, so each reader is only accessed at a fixed index and can stay in registers
+                            std::array<char, PerStep> chars{};
+                            [&]<std::size_t... C>(std::index_sequence<C...>) {
+                                ((chars[C] = codeBook.decode_buffered(local[C % NUM_STREAMS])), ...);
+                            }(std::make_index_sequence<PerStep>{});
+
+                            for(auto const c : chars) {
+                                *out++ = c;
+                            }
+                        }
+                    }
+                }
+
+                for(; i + NUM_STREAMS <= count; i += NUM_STREAMS) {
+                    std::array<char, NUM_STREAMS> chars{};
+                    for(std::size_t s{0}; s < NUM_STREAMS; ++s) {
+                        chars[s] = codeBook.decode(local[s]);
+                    }
+                    for(auto const c : chars) {
+                        *out++ = c;
+                    }
+                }
+
+                // the remaining characters are at the start of the streams
+                for(std::size_t s{0}; i < count; ++i, ++s) {
+                    *out++ = codeBook.decode(local[s]);
+                }
+            }
+
+            StreamStarts const m_Starts;
+            Checkpoints const m_Checkpoints;
+            std::size_t const m_First;          // position of the first character in the stored string
             std::size_t const m_StringLength;
-            void const * m_compressedStream;
-            BitAccessorFunc const m_GetBit;
-            std::span<Node const> const m_Nodes;
+            TBitSource const m_Source;
+            CodeBook const m_CodeBook;
         };
 
+        // A string decoded with shared, type-erased stream access. Smallest code size.
+        using IterableString = BasicIterableString<ErasedBitSource>;
+
+        // A string decoded by reading the bytes of the stream directly. Fastest decode.
+        using FastIterableString = BasicIterableString<ByteBitSource>;
+
 
         // Contains the entries and the bitstream they are based on
-        // to store all the compressed strings
-        template<std::size_t NUM_ENTRIES, std::size_t NUM_ENCODED_BITS, std::size_t NUM_TREE_NODES>
+        // to store all the compressed strings, along with the tables needed to decode them
+        //
+        // The OPTIONS.Decoder selects the type of string returned, but does not change the layout.
+        // Strings that are interleaved start with the length of all but the last of their sub-streams,
+        // then strings with checkpoints have the offset into each sub-stream for each checkpoint, followed
+        // by the sub-streams. Each length and offset is OFFSET_BITS long.
+        template<typename TEntryIndex, std::size_t NUM_ENCODED_BITS, typename TTables, Options OPTIONS = Options{}, std::size_t OFFSET_BITS = 0>
         struct Encoding
         {
-            static constexpr std::size_t NumEntries = NUM_ENTRIES;
+            static constexpr std::size_t NumEntries = TEntryIndex::NumEntries;
             static constexpr std::size_t NumEncodedBits = NUM_ENCODED_BITS;
-            static constexpr std::size_t NumTreeNodes = NUM_TREE_NODES;
+            static constexpr DecodeMode Decoder = OPTIONS.Decoder;
+            static constexpr std::size_t OffsetBits = OFFSET_BITS;
+            using TablesType = TTables;
+            using StringType = std::conditional_t<Decoder == DecodeMode::Fast, FastIterableString, IterableString>;
 
-            constexpr IterableString operator[](std::size_t idx) const
+            constexpr StringType operator[](std::size_t idx) const
             {
                 // bounds check without exceptions
                 if(idx >= NumEntries)
                     return bad_string();
 
-                auto const thisEntry = m_Entries[idx];
-
-                return IterableString{
-                    thisEntry.FirstBit,
-                    thisEntry.OriginalStringLength,
-                    &m_CompressedStream,
-                    [](std::size_t i, std::size_t firstBit, const void *stream) {
-                        return static_cast<const lib::bit_stream<NUM_ENCODED_BITS> *>(stream)->at(i + firstBit); },
-                    std::span{m_HuffmanTable}
-                };
+                return make_string(m_Entries[idx]);
             }
 
             // provide a value that is an implementation defined value representing a
             // bad key or index was requested.
-            constexpr IterableString bad_string() const {
+            constexpr StringType bad_string() const {
                 // this is an empty string
-                return IterableString{
-                    0, 0, nullptr,
-                    [](std::size_t, std::size_t, const void *){ return false; },
-                    std::span{m_HuffmanTable}
-                };
+                return make_string(Entry{0, 0});
             }
 
-            std::array<Entry, NUM_ENTRIES> m_Entries;
+            TEntryIndex m_Entries;
             lib::bit_stream<NUM_ENCODED_BITS> m_CompressedStream;
-            std::array<Node, NUM_TREE_NODES> m_HuffmanTable;
+            TTables m_HuffmanTable;
+
+        private:
+            // find where each sub-stream and checkpoint of the entry starts, from the offsets at the start of the entry
+            constexpr StringType make_string(Entry const &entry) const
+            {
+                auto const length = entry.OriginalStringLength;
+
+                StreamStarts starts{};
+                starts.Count = StreamCount(OPTIONS, length);
+                starts.FirstBit[0] = entry.FirstBit + NumHeaderOffsets(OPTIONS, length) * OffsetBits;
+
+                for(std::size_t i{1}; i < starts.Count; ++i) {
+                    auto const streamLength = m_CompressedStream.peek(entry.FirstBit + (i - 1) * OffsetBits, OffsetBits);
+                    starts.FirstBit[i] = starts.FirstBit[i - 1] + streamLength;
+                }
+
+                Checkpoints const checkpoints{
+                    entry.FirstBit + (starts.Count - 1) * OffsetBits,
+                    NumCheckpoints(OPTIONS, length),
+                    OPTIONS.CheckpointInterval,
+                    OffsetBits };
+
+                if constexpr (Decoder == DecodeMode::Fast) {
+                    return StringType{ starts, length, ByteBitSource{m_CompressedStream.data()}, m_HuffmanTable.code_book(), checkpoints };
+                } else {
+                    return StringType{
+                        starts,
+                        length,
+                        ErasedBitSource{
+                            &m_CompressedStream,
+                            [](std::size_t bit, std::size_t count, const void *stream) {
+                                return static_cast<const lib::bit_stream<NUM_ENCODED_BITS> *>(stream)->peek(bit, count); }
+                        },
+                        m_HuffmanTable.code_book(),
+                        checkpoints
+                    };
+                }
+            }
         };
 
 
         //
-        // Build an array of Nodes which link together using indexes to represent the Huffman tree.
+        // Build an array of CharFrequency structs for each used character from the original strings
+        // capturing its frequency as character value. The table is ordered by character value.
         //
-        // This flattened tree is then used for generating the encoded strings at compile time, and
-        // decoding the strings, character by character at run time.
-        //
-        static constexpr auto BuildHuffmanTree(CallableGivesIterableStringViews auto makeStringsLambda)
+        static constexpr auto BuildFrequencyTable(CallableGivesIterableStringViews auto makeStringsLambda)
         {
             //
             // Count the frequency of all the characters in tall the strings to be compressed
@@ -344,43 +969,45 @@ namespace squeeze {
                 constexpr auto st = makeStringsLambda();
 
                 // one element per possible character value
-                std::array<std::size_t, std::numeric_limits<std::string_view::value_type>::max()> counts{};
+                std::array<std::size_t, 256> counts{};
                 counts.fill(0);
 
                 for(auto &s : st) {
                     for (auto c : s) {
-                        counts.at(static_cast<std::size_t>(c)) += 1;
+                        counts.at(static_cast<unsigned char>(c)) += 1;
                     }
                 }
 
                 return counts;
             };
 
+            constexpr auto counts = CountFrequency();
+            constexpr auto NumEntries = std::count_if(counts.begin(), counts.end(), [](auto i){return i != 0;});
 
-            //
-            // Build an array of CharFrequency structs for each used character from the original strings
-            // capturing its frequency as character value
-            //
-            constexpr auto BuildFrequencyTable = [=]()
-            {
-                constexpr auto counts = CountFrequency();
-                constexpr auto NumEntries = std::count_if(counts.begin(), counts.end(), [](auto i){return i != 0;});
+            std::array<CharFrequency, NumEntries> ft;
+            std::size_t e{0};
+            for(std::size_t i{0}; i < counts.size(); ++i) {
+                if(counts.at(i) == 0) {
+                    continue;
+                }
 
-                std::array<CharFrequency, NumEntries> ft;
-                std::size_t e{0};
-                for(std::size_t i{0}; i < counts.size(); ++i) {
-                    if(counts.at(i) == 0) {
-                        continue;
-                    }
+                ft.at(e++) = CharFrequency{static_cast<char>(i), counts.at(i)};
+            }
 
-                    ft.at(e++) = CharFrequency{static_cast<char>(i), counts.at(i)};
-                }
+            return ft;
+        }
 
-                return ft;
-            };
 
+        //
+        // Build an array of Nodes which link together using indexes to represent the Huffman tree.
+        //
+        // This flattened tree is then used for generating the encoded strings at compile time, and
+        // decoding the strings, character by character at run time.
+        //
+        static constexpr auto BuildHuffmanTree(CallableGivesIterableStringViews auto makeStringsLambda)
+        {
             // compute the frequency table and calculate the number of tree nodes needed
-            constexpr auto ft = BuildFrequencyTable();
+            constexpr auto ft = BuildFrequencyTable(makeStringsLambda);
             constexpr auto NumFtEntries = std::distance(ft.begin(), ft.end());
 
             //
@@ -422,6 +1049,11 @@ namespace squeeze {
 
             constexpr auto NumNodes = CalculateTreeNodeCount();
 
+            // strings with no characters have no tree
+            if constexpr (NumNodes == 0) {
+                return std::array<EncodingNode, NumNodes>{};
+            }
+
             // compare "greater" to build a min-heap priority queue
             auto cmpTreeNode = [](TreeNode const* left, TreeNode const* right){ return left->prob > right->prob; };
 
@@ -511,66 +1143,366 @@ namespace squeeze {
         }
 
 
-        static constexpr auto MakeEncodedBitStream(CallableGivesIterableStringViews auto makeStringsLambda)
+        //
+        // Calculate the code length for the first numSymbols entries in a frequency table, such that no code
+        // is longer than MAX_LENGTH bits and the total encoded length is minimised. This uses the package-merge
+        // algorithm. The rest of the table is ignored, so tables of varying size can share one array type.
+        //
+        // Lengths are returned in the same order as the frequency table.
+        //
+        template<std::size_t MAX_LENGTH, std::size_t CAPACITY>
+        static constexpr auto CalculateLimitedCodeLengths(std::array<CharFrequency, CAPACITY> const &ft, std::size_t numSymbols)
         {
-            // get the string table to work with
-            constexpr auto st = makeStringsLambda();
-            constexpr auto NumStrings = std::distance(st.begin(), st.end());
-
-            // build the huffman tree
-            constexpr auto tree = BuildHuffmanTree(makeStringsLambda);
-
-            // for efficiency of operations during encoding, we will build a lookup table
-            // mapping each character to its tree index and bit length
-            //
-            // NOTE: even with this, we still help limits in Clang when encoding long strings.
-            //
-            // TODO: encode the actual bitstream for each character to lessen the workload more
-            constexpr auto MakeCharacterLookupTable = [=]() {
-                struct CharData
+            std::array<std::size_t, CAPACITY> lengths{};
+
+            // a single symbol still needs a bit to be written for it
+            if(numSymbols == 1) {
+                lengths.at(0) = 1;
+            } else if(numSymbols > 1) {
+                // An item in a package-merge list, either a leaf (symbol) or a package of
+                // two items from the list for the next longer length
+                struct Item
                 {
-                    std::size_t BitLength{0};
-                    lib::bit_stream<256> ReverseStream{};    // worst case imaginable :)
+                    std::size_t Weight{0};
+                    bool IsLeaf{false};
+                    std::size_t Symbol{0};
                 };
 
-                // Build a fast lookup "table" for all the characters
-                std::array<CharData, 256> charLookup;
-
-                for(std::size_t nodeIdx{0}; nodeIdx < tree.size(); ++nodeIdx) {
-                    auto const &node = tree.at(nodeIdx);
-                    if(node.is_leaf())  {
-                        // this is a leaf, find the bit length for this character
-                        std::size_t idx{nodeIdx};
-                        CharData cd;
-
-                        // starting at the character leaf node, walk up the tree
-                        // capturing bits as we go. Note that we are traversing bottom up
-                        // so we have to write the bits into the stream reversed.
-                        while(idx != 0) {
-                            auto const &n = tree.at(idx);
-                            auto const &p = tree.at(n.parent());
-
-                            // determine if this is the one or zero node of the parent
-                            // if the "one" link is our node, bit will be true (1)
-                            // stream is initialised to zero, so we don't need to do clears
-                            if(p[1] == idx) {
-                                cd.ReverseStream.set(cd.BitLength);
-                            }
+                // the leaf items sorted by weight
+                std::array<Item, CAPACITY> leaves;
+                for(std::size_t i{0}; i < numSymbols; ++i) {
+                    leaves.at(i) = Item{ft.at(i).frequency, true, i};
+                }
+                std::sort(leaves.begin(), leaves.begin() + static_cast<std::ptrdiff_t>(numSymbols), [](auto const &a, auto const &b) { return a.Weight < b.Weight; });
+
+                // one list per length, starting with the longest. Each list has the leaves merged with
+                // the packages from pairs of the previous list, so it can hold at most twice the symbols.
+                std::array<std::array<Item, 2 * CAPACITY>, MAX_LENGTH> lists{};
+                std::array<std::size_t, MAX_LENGTH> listSizes{};
+
+                std::copy_n(leaves.begin(), numSymbols, lists.at(0).begin());
+                listSizes.at(0) = numSymbols;
+
+                for(std::size_t level{1}; level < MAX_LENGTH; ++level) {
+                    auto const &previous = lists.at(level - 1);
+                    auto &current = lists.at(level);
+                    auto const numPackages = listSizes.at(level - 1) / 2;
+
+                    // merge the leaves and the packages, both are already ordered by weight
+                    std::size_t leaf{0};
+                    std::size_t package{0};
+                    std::size_t out{0};
+                    while(leaf < numSymbols || package < numPackages) {
+                        std::size_t packageWeight = package < numPackages
+                            ? previous.at(2 * package).Weight + previous.at(2 * package + 1).Weight
+                            : 0;
+
+                        if(package >= numPackages || (leaf < numSymbols && leaves.at(leaf).Weight <= packageWeight)) {
+                            current.at(out++) = leaves.at(leaf++);
+                        } else {
+                            current.at(out++) = Item{packageWeight, false, 0};
+                            ++package;
+                        }
+                    }
+
+                    listSizes.at(level) = out;
+                }
+
+                // Select the first 2n-2 items of the final list. Each leaf selected in any list adds one to
+                // the length of its symbol, and each package selected selects the two items it was made
+                // from in the list before, which are always the first items of that list.
+                std::size_t selected{2 * numSymbols - 2};
+                for(std::size_t level{MAX_LENGTH}; level > 0 && selected > 0; --level) {
+                    std::size_t packages{0};
+                    for(std::size_t i{0}; i < selected; ++i) {
+                        auto const &item = lists.at(level - 1).at(i);
+                        if(item.IsLeaf) {
+                            lengths.at(item.Symbol) += 1;
+                        } else {
+                            ++packages;
+                        }
+                    }
+                    selected = 2 * packages;
+                }
+            }
+
+            return lengths;
+        }
 
-                            // move to next bit
-                            ++cd.BitLength;
-                            idx = n.parent();
+        //
+        // Calculate the code length for each entry in a frequency table, see above.
+        //
+        template<std::size_t MAX_LENGTH, std::size_t NUM_SYMBOLS>
+        static constexpr auto CalculateLimitedCodeLengths(std::array<CharFrequency, NUM_SYMBOLS> const &ft)
+        {
+            static_assert(NUM_SYMBOLS <= (std::size_t{1} << MAX_LENGTH), "MaxCodeLength is too short to encode all characters");
+
+            return CalculateLimitedCodeLengths<MAX_LENGTH>(ft, NUM_SYMBOLS);
+        }
+
+        //
+        // Build the canonical code description from the length limited code lengths. The symbols are
+        // ordered by code length, and then character value, which is the order the codes are assigned in.
+        //
+        template<std::size_t MAX_LENGTH>
+        static constexpr auto BuildCanonicalCode(CallableGivesIterableStringViews auto makeStringsLambda)
+        {
+            constexpr auto ft = BuildFrequencyTable(makeStringsLambda);
+            constexpr auto lengths = CalculateLimitedCodeLengths<MAX_LENGTH>(ft);
+            constexpr auto NumSymbols = ft.size();
+
+            struct CanonicalCode
+            {
+                std::array<char, NumSymbols> Symbols;
+                std::array<std::size_t, NumSymbols> Lengths;
+                std::array<std::uint16_t, MAX_LENGTH + 1> LengthCounts;
+            };
+
+            CanonicalCode result{};
+
+            // the frequency table is in character order, so ordering by length then position gives canonical order
+            std::array<std::size_t, NumSymbols> order{};
+            for(std::size_t i{0}; i < NumSymbols; ++i) {
+                order.at(i) = i;
+            }
+            std::sort(order.begin(), order.end(), [&](auto a, auto b) {
+                return lengths.at(a) < lengths.at(b) || (lengths.at(a) == lengths.at(b) && a < b);
+            });
+
+            for(std::size_t i{0}; i < NumSymbols; ++i) {
+                auto const len = lengths.at(order.at(i));
+                result.Symbols.at(i) = ft.at(order.at(i)).c;
+                result.Lengths.at(i) = len;
+                result.LengthCounts.at(len) += 1;
+            }
+
+            return result;
+        }
+
+        //
+        // Build the code for each character by walking up the tree from its leaf
+        //
+        template<std::size_t NUM_TREE_NODES>
+        static constexpr auto MakeTreeCharacterCodes(std::array<EncodingNode, NUM_TREE_NODES> const &tree)
+        {
+            // Build a fast lookup "table" for all the characters
+            std::array<CharCode, 256> charLookup;
+
+            for(std::size_t nodeIdx{0}; nodeIdx < tree.size(); ++nodeIdx) {
+                auto const &node = tree.at(nodeIdx);
+                if(node.is_leaf())  {
+                    // this is a leaf, find the bit length for this character
+                    std::size_t idx{nodeIdx};
+                    lib::bit_stream<256> reverseStream;
+                    CharCode cd;
+
+                    // starting at the character leaf node, walk up the tree
+                    // capturing bits as we go. Note that we are traversing bottom up
+                    // so we have to write the bits into the stream reversed.
+                    while(idx != 0) {
+                        auto const &n = tree.at(idx);
+                        auto const &p = tree.at(n.parent());
+
+                        // determine if this is the one or zero node of the parent
+                        // if the "one" link is our node, bit will be true (1)
+                        // stream is initialised to zero, so we don't need to do clears
+                        if(p[1] == idx) {
+                            reverseStream.set(cd.BitLength);
                         }
 
-                        // store the character data for this node's character
-                        charLookup.at(static_cast<std::size_t>(node.value())) = cd;
+                        // move to next bit
+                        ++cd.BitLength;
+                        idx = n.parent();
+                    }
+
+                    // put the bits back into the order they will be written
+                    for(std::size_t b{0}; b < cd.BitLength; ++b) {
+                        if(reverseStream.at(cd.BitLength - 1 - b)) {
+                            cd.Bits.set(b);
+                        }
                     }
+
+                    // store the character data for this node's character
+                    charLookup.at(static_cast<unsigned char>(node.value())) = cd;
                 }
+            }
 
-                return charLookup;
+            return charLookup;
+        }
+
+        //
+        // Build the code for each character by assigning consecutive codes in canonical order
+        //
+        template<typename TCanonicalCode>
+        static constexpr auto MakeCanonicalCharacterCodes(TCanonicalCode const &canonical)
+        {
+            std::array<CharCode, 256> charLookup;
+
+            std::uint64_t code{0};
+            std::size_t prevLength{canonical.Lengths.empty() ? 0 : canonical.Lengths.front()};
+            for(std::size_t i{0}; i < canonical.Symbols.size(); ++i) {
+                auto const len = canonical.Lengths.at(i);
+                code <<= (len - prevLength);
+                prevLength = len;
+
+                // the code is written most significant bit first
+                CharCode cd;
+                cd.BitLength = len;
+                for(std::size_t b{0}; b < len; ++b) {
+                    if(((code >> (len - 1 - b)) & 1u) != 0) {
+                        cd.Bits.set(b);
+                    }
+                }
+                charLookup.at(static_cast<unsigned char>(canonical.Symbols.at(i))) = cd;
+
+                ++code;
+            }
+
+            return charLookup;
+        }
+
+        //
+        // Build the decode tables for a Huffman tree, which are the packed tree and optionally a lookup table.
+        //
+        // For every possible value of the next LookupBits bits, walk the tree as far as those bits take us.
+        // If we reach a leaf, we have the character and its code length, otherwise we record the node to
+        // continue the walk from.
+        //
+        template<std::size_t LOOKUP_BITS, std::size_t NUM_TREE_NODES>
+        static constexpr auto MakeTreeTables(std::array<EncodingNode, NUM_TREE_NODES> const &tree)
+        {
+            TreeTables<NUM_TREE_NODES, LOOKUP_BITS> tables{};
+
+            // number the intermediate nodes in tree order, so the root is still 0
+            std::array<Node::IndexType, NUM_TREE_NODES> packedIndex{};
+            Node::IndexType numIntermediate{0};
+            for(std::size_t i{0}; i < tree.size(); ++i) {
+                if(!tree.at(i).is_leaf()) {
+                    packedIndex.at(i) = numIntermediate++;
+                }
+            }
+
+            // a link to a leaf holds its character, otherwise it is the packed index of the node
+            auto const link = [&](std::size_t nodeIdx) {
+                auto const &node = tree.at(nodeIdx);
+                return node.is_leaf() ? Node::LeafLink(node.value()) : packedIndex.at(nodeIdx);
             };
 
-            constexpr auto charLookup = MakeCharacterLookupTable();
+            for(std::size_t i{0}; i < tree.size(); ++i) {
+                if(!tree.at(i).is_leaf()) {
+                    tables.m_Links.at(0).at(packedIndex.at(i)) = link(tree.at(i)[0]);
+                    tables.m_Links.at(1).at(packedIndex.at(i)) = link(tree.at(i)[1]);
+                }
+            }
+
+            // a tree with no strings has no nodes. Decode gives the same null character as a bad encoding
+            tables.m_Root = tree.empty() ? Node::LeafLink('\0') : link(0);
+
+            for(std::size_t bits{0}; bits < tables.m_Lookup.size() && !tree.empty(); ++bits) {
+                std::size_t nodeIdx{0};
+                std::size_t len{0};
+
+                while(!tree.at(nodeIdx).is_leaf() && len < LOOKUP_BITS) {
+                    nodeIdx = tree.at(nodeIdx)[(bits >> len) & 1u];
+                    ++len;
+                }
+
+                auto const &node = tree.at(nodeIdx);
+                if(node.is_leaf()) {
+                    tables.m_Lookup.at(bits) = LookupEntry{
+                        static_cast<Node::IndexType>(static_cast<unsigned char>(node.value())),
+                        static_cast<std::uint8_t>(len),
+                        true };
+                } else {
+                    tables.m_Lookup.at(bits) = LookupEntry{
+                        packedIndex.at(nodeIdx),
+                        static_cast<std::uint8_t>(len),
+                        false };
+                }
+            }
+
+            return tables;
+        }
+
+        //
+        // Build the decode tables for a canonical code, and optionally a lookup table.
+        //
+        // Each code that fits in the lookup table fills every entry that starts with its bits. Entries
+        // for longer codes are left to restart decoding from the beginning of the code.
+        //
+        template<std::size_t LOOKUP_BITS, std::size_t MAX_LENGTH, typename TCanonicalCode>
+        static constexpr auto MakeCanonicalTables(TCanonicalCode const &canonical, std::array<CharCode, 256> const &codes)
+        {
+            CanonicalTables<std::tuple_size_v<decltype(canonical.Symbols)>, MAX_LENGTH, LOOKUP_BITS> tables{};
+            tables.m_Symbols = canonical.Symbols;
+            tables.m_LengthCounts = canonical.LengthCounts;
+
+            for(auto &entry : tables.m_Lookup) {
+                entry = LookupEntry{0, 0, false};
+            }
+
+            for(auto const c : canonical.Symbols) {
+                auto const &cd = codes.at(static_cast<unsigned char>(c));
+                if(cd.BitLength > LOOKUP_BITS) {
+                    continue;
+                }
+
+                // the lookup index has the first bit of the code in the least significant position
+                auto const prefix = cd.Bits.peek(0, cd.BitLength);
+
+                for(std::size_t rest{0}; rest < (std::size_t{1} << (LOOKUP_BITS - cd.BitLength)); ++rest) {
+                    tables.m_Lookup.at(prefix | (rest << cd.BitLength)) = LookupEntry{
+                        static_cast<Node::IndexType>(static_cast<unsigned char>(c)),
+                        static_cast<std::uint8_t>(cd.BitLength),
+                        true };
+                }
+            }
+
+            return tables;
+        }
+
+
+        template<Options OPTIONS = Options{}>
+        static constexpr auto MakeEncodedBitStream(CallableGivesIterableStringViews auto makeStringsLambda)
+        {
+            // the lookup table entries are indexed with 16 bits at most
+            static_assert(OPTIONS.LookupBits <= 16, "LookupBits must be 16 or less");
+            static_assert(OPTIONS.InterleaveStreams >= 1 && OPTIONS.InterleaveStreams <= MaxInterleavedStreams,
+                          "Strings can be interleaved into at most 4 sub-streams");
+            static_assert(OPTIONS.CheckpointInterval == 0 || OPTIONS.InterleaveThreshold == 0 || OPTIONS.CheckpointInterval % OPTIONS.InterleaveStreams == 0,
+                          "CheckpointInterval must be a multiple of InterleaveStreams");
+            static_assert(OPTIONS.MaxCodeLength <= 32, "MaxCodeLength must be 32 or less");
+
+            constexpr bool Canonical = OPTIONS.MaxCodeLength != 0;
+
+            // get the string table to work with
+            constexpr auto st = makeStringsLambda();
+            constexpr auto NumStrings = std::distance(st.begin(), st.end());
+
+            // Build the code for each character, and the tables needed to decode them. This is either
+            // a huffman tree, or the length limited canonical code.
+            //
+            // The character lookup table maps each character to its code and bit length for efficiency
+            // of operations during encoding
+            //
+            // NOTE: even with this, we still help limits in Clang when encoding long strings.
+            constexpr auto MakeCodes = [=]() {
+                if constexpr (Canonical) {
+                    constexpr auto canonical = BuildCanonicalCode<OPTIONS.MaxCodeLength>(makeStringsLambda);
+                    constexpr auto charLookup = MakeCanonicalCharacterCodes(canonical);
+                    return std::pair{
+                        charLookup,
+                        MakeCanonicalTables<OPTIONS.LookupBits, OPTIONS.MaxCodeLength>(canonical, charLookup) };
+                } else {
+                    constexpr auto tree = BuildHuffmanTree(makeStringsLambda);
+                    return std::pair{
+                        MakeTreeCharacterCodes(tree),
+                        MakeTreeTables<OPTIONS.LookupBits>(tree) };
+                }
+            };
+
+            constexpr auto codes = MakeCodes();
+            constexpr auto charLookup = codes.first;
 
             // Calculate the length in bits of a string when compressed
             constexpr auto CalculateStringLength = [=](std::string_view s) -> std::size_t
@@ -578,13 +1510,59 @@ namespace squeeze {
                 std::size_t len{0};
 
                 for(char const c : s) {
-                    len += charLookup.at(static_cast<std::size_t>(c)).BitLength;
+                    len += charLookup.at(static_cast<unsigned char>(c)).BitLength;
                 }
 
                 return len;
             };
 
-            // build an array of bit lengths for the resulting compressed strings
+            // Encode a string into the bitstream, starting at the firstBit location. Only every step'th
+            // character from the first is encoded, so we can write each interleaved sub-stream.
+            constexpr auto EncodeString = [=]<std::size_t NUM_BITS>(std::string_view str, std::size_t const firstBit, lib::bit_stream<NUM_BITS> &stream, std::size_t first = 0, std::size_t step = 1)
+            {
+                std::size_t i{0};
+
+                for(std::size_t pos{first}; pos < str.size(); pos += step) {
+                    // Get the character data
+                    auto const &cd = charLookup.at(static_cast<unsigned char>(str[pos]));
+
+                    // copy the code into the stream as many bits at a time as we can
+                    for(std::size_t done{0}; done < cd.BitLength; done += lib::bit_stream<NUM_BITS>::MaxBulkBits) {
+                        auto const count = std::min(cd.BitLength - done, lib::bit_stream<NUM_BITS>::MaxBulkBits);
+                        stream.write(firstBit + i + done, cd.Bits.peek(done, count), count);
+                    }
+
+                    i += cd.BitLength;
+                }
+
+                return i;
+            };
+
+
+            // the number of sub-streams, checkpoints and offsets stored at the start of a string
+            constexpr auto Streams = [](std::string_view s) { return StreamCount(OPTIONS, s.size()); };
+            constexpr auto NumStringCheckpoints = [](std::string_view s) { return NumCheckpoints(OPTIONS, s.size()); };
+            constexpr auto HeaderOffsets = [](std::string_view s) { return NumHeaderOffsets(OPTIONS, s.size()); };
+
+            // the number of bits needed to store any offset at the start of a string. Offsets are
+            // within the encoded string, so can be no longer than it
+            constexpr auto CalculateOffsetBits = [=]()
+            {
+                std::size_t longest{0};
+
+                for(auto const &s : st) {
+                    if(HeaderOffsets(s) != 0) {
+                        longest = std::max(longest, CalculateStringLength(s));
+                    }
+                }
+
+                return lib::bits_needed(longest);
+            };
+
+            constexpr auto offsetBits = CalculateOffsetBits();
+
+            // build an array of bit lengths for the resulting compressed strings, including the
+            // offsets stored at their start
             constexpr auto CalculateEncodedStringBitLengths = [=]()
             {
                 // we will return an array of lengths in bits
@@ -592,61 +1570,111 @@ namespace squeeze {
 
                 std::size_t i{0};
                 for(auto const &s : st) {
-                    result.at(i) = CalculateStringLength(s);
+                    result.at(i) = CalculateStringLength(s) + HeaderOffsets(s) * offsetBits;
                     ++i;
                 }
 
                 return result;
             };
 
-            // Encode a string into the bitstream, starting at the firstBit location
-            constexpr auto EncodeString = [=]<std::size_t NUM_BITS>(std::string_view str, std::size_t const firstBit, lib::bit_stream<NUM_BITS> &stream)
+            // Write the offset of each checkpoint's character in a sub-stream, from the start of the
+            // sub-stream. Checkpoint k is at character k * CheckpointInterval + stream.
+            constexpr auto WriteCheckpoints = [=]<std::size_t NUM_BITS>(std::string_view str, std::size_t const firstBit, lib::bit_stream<NUM_BITS> &stream, std::size_t sub, std::size_t numStreams)
             {
-                std::size_t i{0};
-
-                for(char const c : str) {
-                    // Get the character data
-                    auto cd = charLookup.at(static_cast<std::size_t>(c));
-
-                    auto cLen = cd.BitLength;
-
-                    // Note that we stored the bit stream in the character data reversed to make it simpler
-                    // to store, we just simply need to copy out backwards
-                    while(cLen > 0) {
-                        if(cd.ReverseStream.at(cLen-1))
-                            stream.set(firstBit+i);
+                auto const count = NumStringCheckpoints(str);
+                if(count == 0) {
+                    return;
+                }
 
-                        ++i;
-                        --cLen;
+                std::size_t offset{0};
+                for(std::size_t pos{sub}; pos < str.size(); pos += numStreams) {
+                    auto const k = (pos - sub) / OPTIONS.CheckpointInterval;
+                    if(k >= 1 && k <= count && (pos - sub) % OPTIONS.CheckpointInterval == 0) {
+                        stream.write(firstBit + ((k - 1) * numStreams + sub) * offsetBits, offset, offsetBits);
                     }
-                }
 
-                return i;
+                    offset += charLookup.at(static_cast<unsigned char>(str[pos])).BitLength;
+                }
             };
 
-
-            // get the encoded string lengths
             constexpr auto stringLengths = CalculateEncodedStringBitLengths();
 
-            constexpr auto totalEncodedLength = std::accumulate(stringLengths.begin(), stringLengths.end(), 0);
+            // Identical strings share one encoding. A string that is the suffix of another is read from the end
+            // of its encoding, as long as neither has offsets at their start. The Elias-Fano index needs the
+            // first bits in index order, so nothing is shared with it.
+            constexpr auto owners = [=]() {
+                if constexpr (OPTIONS.Index == IndexMode::EliasFano) {
+                    std::array<std::size_t, NumStrings> result{};
+                    std::iota(result.begin(), result.end(), std::size_t{0});
+                    return result;
+                } else {
+                    return lib::suffix_owners<NumStrings>(st, [=](std::size_t idx) {
+                        return NumHeaderOffsets(OPTIONS, (st.begin() + static_cast<std::ptrdiff_t>(idx))->size()) == 0; });
+                }
+            }();
+
+            constexpr auto totalEncodedLength = [=]() {
+                std::size_t total{0};
+                for(std::size_t i{0}; i < stringLengths.size(); ++i) {
+                    if(owners.at(i) == i) {
+                        total += stringLengths.at(i);
+                    }
+                }
+                return total;
+            }();
+
+            constexpr auto maxStringLength = std::accumulate(
+                    st.begin(), st.end(), std::size_t{0},
+                    [](std::size_t longest, auto const &sv){ return std::max(longest, sv.size()); });
 
-            // create a suitable bit stream to hold the data
-            Encoding<NumStrings, totalEncodedLength, tree.size()> result;
+            // create a suitable bit stream to hold the data, with the narrowest index that can locate every string
+            Encoding<EntryIndexType<OPTIONS.Index, NumStrings, totalEncodedLength, maxStringLength>, totalEncodedLength, std::remove_cvref_t<decltype(codes.second)>, OPTIONS, offsetBits> result;
 
             // Build the entries into the result and write the compressed bit stream
+            std::array<std::size_t, NumStrings> firstBits{};
             std::size_t entry{0};
             std::size_t bit{0};
             for(auto &sv : st) {
+                // strings sharing another's encoding are located once it is written
+                if(owners.at(entry) != entry) {
+                    ++entry;
+                    continue;
+                }
+
                 // save the original length and the start bit for this string
-                result.m_Entries.at(entry) = Entry{bit, sv.size() };
+                firstBits.at(entry) = bit;
+                result.m_Entries.set(entry, Entry{bit, sv.size()});
+
+                // the sub-streams follow the lengths of all but the last of them, then the checkpoints
+                auto const numStreams = Streams(sv);
+                auto const checkpointBit = bit + (numStreams - 1) * offsetBits;
+                auto streamBit = bit + HeaderOffsets(sv) * offsetBits;
+
+                for(std::size_t s{0}; s < numStreams; ++s) {
+                    auto const numBits = EncodeString(sv, streamBit, result.m_CompressedStream, s, numStreams);
+                    if(s + 1 < numStreams) {
+                        result.m_CompressedStream.write(bit + s * offsetBits, numBits, offsetBits);
+                    }
+                    WriteCheckpoints(sv, checkpointBit, result.m_CompressedStream, s, numStreams);
+                    streamBit += numBits;
+                }
+
+                bit = streamBit;
+                ++entry;
+            }
 
-                auto numBits = EncodeString(sv, bit, result.m_CompressedStream);
+            // strings sharing another's encoding end where it ends
+            entry = 0;
+            for(auto &sv : st) {
+                auto const owner = owners.at(entry);
+                if(owner != entry) {
+                    result.m_Entries.set(entry, Entry{firstBits.at(owner) + stringLengths.at(owner) - stringLengths.at(entry), sv.size()});
+                }
                 ++entry;
-                bit += numBits;
             }
 
-            // copy the huffman tree into the result
-            std::copy(tree.begin(), tree.end(), result.m_HuffmanTable.begin());
+            // copy the decode tables into the result
+            result.m_HuffmanTable = codes.second;
 
             return result;
         }
@@ -654,13 +1682,14 @@ namespace squeeze {
 
     }
 
-    class HuffmanEncoder
+    template<huffman::Options OPTIONS = huffman::Options{}>
+    class BasicHuffmanEncoder
     {
     public:
 
         static constexpr auto Compile(CallableGivesIterableStringViews auto makeStringsLambda)
         {
-            constexpr auto const encoding = huffman::MakeEncodedBitStream(makeStringsLambda);
+            constexpr auto const encoding = huffman::MakeEncodedBitStream<OPTIONS>(makeStringsLambda);
 
             return encoding;
         }
@@ -671,6 +1700,20 @@ namespace squeeze {
 
     };
 
+    // Huffman encoding decoded by walking the tree one bit at a time. Smallest representation.
+    using HuffmanEncoder = BasicHuffmanEncoder<>;
+
+    // Huffman encoding with an 8 bit decode lookup table, which decodes most characters in a single step.
+    using TableHuffmanEncoder = BasicHuffmanEncoder<huffman::Options{.LookupBits = 8}>;
+
+    // Canonical Huffman encoding with codes limited to 12 bits. Only the symbols and code length counts are
+    // stored to decode, rather than the whole tree.
+    using CanonicalHuffmanEncoder = BasicHuffmanEncoder<huffman::Options{.MaxCodeLength = 12}>;
+
+    // Canonical Huffman encoding with a lookup table, decoded by reading the stream directly for speed
+    using FastHuffmanEncoder = BasicHuffmanEncoder<huffman::Options{
+        .LookupBits = 10, .MaxCodeLength = 12, .Decoder = huffman::DecodeMode::Fast}>;
+
 
 }
 
@@ -0,0 +1,352 @@
+#ifndef SQUEEZE_HYBRIDENCODER_H
+#define SQUEEZE_HYBRIDENCODER_H
+
+#include <string_view>
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstdint>
+#include <iterator>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <type_traits>
+
+#include "concepts.h"
+#include "huffmanencoder.h"
+#include "lib/bit_reader.h"
+#include "lib/bit_stream.h"
+#include "lib/decode_iterator.h"
+
+namespace squeeze
+{
+    namespace hybrid {
+
+        // Compile time options controlling how a HybridEncoder codes the strings it doesn't store raw
+        struct Options
+        {
+            // Canonical codes are limited to this many bits
+            std::size_t MaxCodeLength{12};
+
+            // Number of bits used to index the decode lookup table, 0 disables the table.
+            // See huffman::Options::LookupBits.
+            std::size_t LookupBits{0};
+        };
+
+
+        // Represents a string that is being accessed. Strings stored raw are read in place, the others are
+        // decoded a character at a time as they are iterated.
+        class IterableString
+        {
+        private:
+            // the position in a raw string, or the reader of a coded one
+            struct Cursor
+            {
+                lib::bit_reader Reader{};
+                std::size_t Position{0};
+            };
+
+        public:
+            using Iterator = lib::decode_iterator<IterableString>;
+            friend Iterator;
+
+            // a string stored raw
+            constexpr explicit IterableString(std::string_view raw)
+                : m_Raw{raw}
+                , m_StringLength{raw.size()}
+                , m_IsRaw{true}
+            {}
+
+            // a string stored coded
+            constexpr IterableString(std::span<std::uint8_t const> stream, std::size_t firstBit, std::size_t stringLength, huffman::CodeBook codeBook)
+                : m_Stream{stream}
+                , m_FirstBit{firstBit}
+                , m_StringLength{stringLength}
+                , m_CodeBook{codeBook}
+                , m_IsRaw{false}
+            {}
+
+            [[nodiscard]] constexpr std::size_t size() const { return m_StringLength; }
+
+            [[nodiscard]] constexpr Iterator begin() const { return Iterator{*this}; }
+            [[nodiscard]] constexpr Iterator end() const { return Iterator{typename Iterator::EndPosition{*this}}; }
+
+            // The string in place if it is stored raw, without copying or decoding it
+            [[nodiscard]] constexpr std::optional<std::string_view> raw() const
+            {
+                if(m_IsRaw) {
+                    return m_Raw;
+                }
+                return std::nullopt;
+            }
+
+            // Decode the string into dest, stopping early if dest is too small.
+            // Returns the number of characters written.
+            constexpr std::size_t decode_into(std::span<char> dest) const
+            {
+                return decode_n(dest.begin(), std::min(dest.size(), m_StringLength));
+            }
+
+            // Decode the whole string to the output iterator. Returns the number of characters written.
+            template<typename TOutputIt>
+            constexpr std::size_t copy_to(TOutputIt out) const
+            {
+                return decode_n(out, m_StringLength);
+            }
+
+        private:
+            // raw strings need no decoder
+            [[nodiscard]] constexpr Cursor start() const
+            {
+                return m_IsRaw ? Cursor{} : Cursor{lib::bit_reader{m_Stream, m_FirstBit}, 0};
+            }
+
+            constexpr char next(Cursor &cursor) const
+            {
+                return m_IsRaw ? m_Raw[cursor.Position++] : m_CodeBook.decode(cursor.Reader);
+            }
+
+            template<typename TOutputIt>
+            constexpr std::size_t decode_n(TOutputIt out, std::size_t count) const
+            {
+                if(m_IsRaw) {
+                    std::copy_n(m_Raw.begin(), count, out);
+                    return count;
+                }
+
+                auto cursor = start();
+                for(std::size_t i{0}; i < count; ++i) {
+                    *out++ = next(cursor);
+                }
+                return count;
+            }
+
+            std::string_view m_Raw{};
+            std::span<std::uint8_t const> m_Stream{};
+            std::size_t m_FirstBit{0};
+            std::size_t m_StringLength;
+            huffman::CodeBook m_CodeBook{};
+            bool m_IsRaw;
+        };
+
+
+        template<typename TEntryIndex, std::size_t NUM_ENCODED_BITS, std::size_t RAW_LENGTH, typename TTables>
+        struct Encoding
+        {
+            static constexpr std::size_t NumEntries = TEntryIndex::NumEntries;
+            static constexpr std::size_t NumEncodedBits = NUM_ENCODED_BITS;
+
+            using StringType = IterableString;
+
+            constexpr StringType operator[](std::size_t idx) const
+            {
+                // bounds check without exceptions
+                if(idx >= NumEntries)
+                    return bad_string();
+
+                // the entry's start is an offset into the raw strings or a bit in the coded stream
+                auto const entry = m_Entries[idx];
+                if(m_IsRaw.at(idx)) {
+                    return StringType{std::string_view{m_RawStrings.data() + entry.FirstBit, entry.OriginalStringLength}};
+                }
+                return StringType{m_CompressedStream.data(), entry.FirstBit, entry.OriginalStringLength, m_HuffmanTable.code_book()};
+            }
+
+            // provide a value that is an implementation defined value representing a
+            // bad key or index was requested.
+            constexpr StringType bad_string() const {
+                // this is an empty string
+                return StringType{std::string_view{}};
+            }
+
+            TEntryIndex m_Entries;
+            lib::bit_stream<NumEntries> m_IsRaw;
+            std::array<char, RAW_LENGTH> m_RawStrings;
+            lib::bit_stream<NUM_ENCODED_BITS> m_CompressedStream;
+            [[no_unique_address]] TTables m_HuffmanTable;
+        };
+
+
+        // Stands in for the decode tables when every string is stored raw
+        struct NoTables
+        {
+            [[nodiscard]] constexpr huffman::CodeBook code_book() const { return {}; }
+        };
+
+
+        template<Options OPTIONS, std::size_t ROUND>
+        static constexpr auto CodedStrings(CallableGivesIterableStringViews auto makeStringsLambda) -> CallableGivesIterableStringViews auto;
+
+        // Whether each string is smaller stored raw than coded. Round 0 codes with the code of every string, each
+        // later round with the code of the strings the round before left coded. Strings that don't shrink are
+        // stored raw, as they are faster to access.
+        template<Options OPTIONS, std::size_t ROUND>
+        static constexpr auto ChooseRaw(CallableGivesIterableStringViews auto makeStringsLambda)
+        {
+            constexpr auto st = makeStringsLambda();
+            constexpr auto NumStrings = static_cast<std::size_t>(std::distance(st.begin(), st.end()));
+
+            constexpr auto canonical = [=]() {
+                if constexpr (ROUND == 0) {
+                    return huffman::BuildCanonicalCode<OPTIONS.MaxCodeLength>(makeStringsLambda);
+                } else {
+                    return huffman::BuildCanonicalCode<OPTIONS.MaxCodeLength>(CodedStrings<OPTIONS, ROUND - 1>(makeStringsLambda));
+                }
+            }();
+            constexpr auto charLookup = huffman::MakeCanonicalCharacterCodes(canonical);
+
+            // a character the code leaves out can't be coded at all
+            std::array<bool, NumStrings> result{};
+            std::size_t s{0};
+            for(std::string_view const str : st) {
+                std::size_t bits{0};
+                bool codable{true};
+                for(auto const c : str) {
+                    auto const length = charLookup.at(static_cast<unsigned char>(c)).BitLength;
+                    bits += length;
+                    codable = codable && length > 0;
+                }
+                result.at(s++) = !codable || bits >= str.size() * CHAR_BIT;
+            }
+            return result;
+        }
+
+        // The strings that round ROUND doesn't store raw, so the code is only built from the characters it codes
+        template<Options OPTIONS, std::size_t ROUND>
+        static constexpr auto CodedStrings(CallableGivesIterableStringViews auto makeStringsLambda) -> CallableGivesIterableStringViews auto
+        {
+            return [=]() {
+                constexpr auto st = makeStringsLambda();
+                constexpr auto isRaw = ChooseRaw<OPTIONS, ROUND>(makeStringsLambda);
+                constexpr auto NumCoded = static_cast<std::size_t>(std::count(isRaw.begin(), isRaw.end(), false));
+
+                std::array<std::string_view, NumCoded> result;
+                std::size_t idx{0};
+                std::size_t s{0};
+                for(std::string_view const str : st) {
+                    if(!isRaw.at(s++)) {
+                        result.at(idx++) = str;
+                    }
+                }
+                return result;
+            };
+        }
+
+        // The first round whose choice the code of its own coded strings doesn't change, so every string was
+        // chosen with the code it is stored with. Gives up after a few rounds if the choice keeps changing.
+        template<Options OPTIONS, std::size_t ROUND = 0>
+        static constexpr std::size_t StableRound(CallableGivesIterableStringViews auto makeStringsLambda)
+        {
+            constexpr std::size_t MaxRounds = 4;
+
+            if constexpr (ROUND + 1 == MaxRounds) {
+                return ROUND;
+            } else if constexpr (ChooseRaw<OPTIONS, ROUND>(makeStringsLambda) == ChooseRaw<OPTIONS, ROUND + 1>(makeStringsLambda)) {
+                return ROUND;
+            } else {
+                return StableRound<OPTIONS, ROUND + 1>(makeStringsLambda);
+            }
+        }
+
+        template<Options OPTIONS = Options{}>
+        static constexpr auto MakeEncoding(CallableGivesIterableStringViews auto makeStringsLambda)
+        {
+            // get the string table to work with
+            constexpr auto st = makeStringsLambda();
+            constexpr auto NumStrings = static_cast<std::size_t>(std::distance(st.begin(), st.end()));
+            constexpr auto MaxStringLength = std::accumulate(
+                    st.begin(), st.end(), std::size_t{0},
+                    [](std::size_t longest, auto const &sv){ return std::max(longest, sv.size()); });
+
+            constexpr auto TotalLength = std::accumulate(
+                    st.begin(), st.end(), std::size_t{0},
+                    [](auto total, auto const &sv){ return total + sv.size(); });
+
+            // the code for the strings that are coded
+            constexpr auto Round = StableRound<OPTIONS>(makeStringsLambda);
+            constexpr auto coded = CodedStrings<OPTIONS, Round>(makeStringsLambda);
+            constexpr auto canonical = huffman::BuildCanonicalCode<OPTIONS.MaxCodeLength>(coded);
+            constexpr auto charLookup = huffman::MakeCanonicalCharacterCodes(canonical);
+
+            constexpr auto chosenRaw = ChooseRaw<OPTIONS, Round>(makeStringsLambda);
+            constexpr auto ChosenLengths = [=]() {
+                std::pair<std::size_t, std::size_t> result{0, 0};   // raw characters, coded bits
+                std::size_t s{0};
+                for(std::string_view const str : st) {
+                    if(chosenRaw.at(s++)) {
+                        result.first += str.size();
+                    } else {
+                        for(auto const c : str) {
+                            result.second += charLookup.at(static_cast<unsigned char>(c)).BitLength;
+                        }
+                    }
+                }
+                return result;
+            }();
+            using CodedTablesType = decltype(huffman::MakeCanonicalTables<OPTIONS.LookupBits, OPTIONS.MaxCodeLength>(canonical, charLookup));
+
+            // store every string raw, with no code, when the coded strings and their code are no smaller
+            constexpr bool AllRaw = TotalLength <=
+                ChosenLengths.first + (ChosenLengths.second + CHAR_BIT - 1) / CHAR_BIT + sizeof(CodedTablesType);
+
+            constexpr auto isRaw = [=]() {
+                auto result = chosenRaw;
+                if(AllRaw) {
+                    result.fill(true);
+                }
+                return result;
+            }();
+            constexpr auto RawLength = AllRaw ? TotalLength : ChosenLengths.first;
+            constexpr auto EncodedBits = AllRaw ? 0 : ChosenLengths.second;
+
+            using EntryIndexType = huffman::EntryIndex<NumStrings, std::max(RawLength, EncodedBits), MaxStringLength>;
+            using TablesType = std::conditional_t<AllRaw, NoTables, CodedTablesType>;
+            Encoding<EntryIndexType, EncodedBits, RawLength, TablesType> result{};
+
+            std::size_t entry{0};
+            std::size_t raw{0};
+            std::size_t bit{0};
+            for(std::string_view const str : st) {
+                if(isRaw.at(entry)) {
+                    result.m_IsRaw.set(entry);
+                    result.m_Entries.set(entry, huffman::Entry{raw, str.size()});
+                    raw = static_cast<std::size_t>(std::distance(result.m_RawStrings.begin(),
+                        std::copy(str.begin(), str.end(), result.m_RawStrings.begin() + static_cast<std::ptrdiff_t>(raw))));
+                } else {
+                    result.m_Entries.set(entry, huffman::Entry{bit, str.size()});
+                    for(auto const c : str) {
+                        auto const &cd = charLookup.at(static_cast<unsigned char>(c));
+                        result.m_CompressedStream.write(bit, cd.Bits.peek(0, cd.BitLength), cd.BitLength);
+                        bit += cd.BitLength;
+                    }
+                }
+                ++entry;
+            }
+
+            if constexpr (!AllRaw) {
+                result.m_HuffmanTable = huffman::MakeCanonicalTables<OPTIONS.LookupBits, OPTIONS.MaxCodeLength>(canonical, charLookup);
+            }
+
+            return result;
+        }
+    }
+
+    template<hybrid::Options OPTIONS = hybrid::Options{}>
+    class BasicHybridEncoder
+    {
+    public:
+
+        static constexpr auto Compile(CallableGivesIterableStringViews auto makeStringsLambda)
+        {
+            constexpr auto const encoding = hybrid::MakeEncoding<OPTIONS>(makeStringsLambda);
+
+            return encoding;
+        }
+    };
+
+    // Each string is stored raw or canonical Huffman coded, whichever is smaller
+    using HybridEncoder = BasicHybridEncoder<>;
+
+}
+
+#endif //SQUEEZE_HYBRIDENCODER_H
@@ -0,0 +1,123 @@
+#ifndef SQUEEZE_BIT_READER_H
+#define SQUEEZE_BIT_READER_H
+
+#include <bit>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+namespace squeeze::lib
+{
+    //
+    // Reads a stream of bits stored in bytes, first bit in the least significant position of the
+    // first byte (the same layout as a byte stored bit_stream).
+    //
+    // Bits are buffered in a local 64 bit word, so consecutive peeks and consumes only touch memory
+    // when the buffer needs refilling. After a refill at least MaxPeekBits are available.
+    // Bytes past the end of the data read as zero.
+    //
+    class bit_reader
+    {
+    public:
+        using value_type = std::uint64_t;
+
+        // the most bits that can be peeked in one call
+        constexpr static std::size_t MaxPeekBits = sizeof(value_type) * CHAR_BIT - CHAR_BIT + 1;
+
+        constexpr bit_reader() = default;
+
+        constexpr bit_reader(std::span<std::uint8_t const> data, std::size_t firstBit)
+            : m_Data{data}
+            , m_NextByte{firstBit / CHAR_BIT}
+        {
+            refill();
+            consume(firstBit % CHAR_BIT);
+        }
+
+        // get the next count bits (up to MaxPeekBits) without consuming them
+        [[nodiscard]] constexpr value_type peek(std::size_t count)
+        {
+            if(m_Count < count) {
+                refill();
+            }
+
+            return m_Buffer & mask(count);
+        }
+
+        // move past count bits, which must have been peeked
+        constexpr void consume(std::size_t count)
+        {
+            m_Buffer >>= count;
+            m_Count -= count;
+        }
+
+        // get and consume the next count bits (up to MaxPeekBits)
+        constexpr value_type read(std::size_t count)
+        {
+            auto const result = peek(count);
+            consume(count);
+            return result;
+        }
+
+        // make sure at least count bits (up to MaxPeekBits) are buffered, so they can be taken with
+        // peek_buffered() and consume() without checking the buffer each time
+        constexpr void ensure(std::size_t count)
+        {
+            if(m_Count < count) {
+                refill();
+            }
+        }
+
+        // get the next count bits (less than the buffer size) that ensure() has already buffered
+        [[nodiscard]] constexpr value_type peek_buffered(std::size_t count) const
+        {
+            return m_Buffer & ((value_type{1} << count) - 1);
+        }
+
+    private:
+        constexpr static std::size_t BufferBits = sizeof(value_type) * CHAR_BIT;
+
+        // a value with the lowest n bits set
+        constexpr static value_type mask(std::size_t n)
+        {
+            return n >= BufferBits ? ~value_type{0} : (value_type{1} << n) - 1;
+        }
+
+        // top up the buffer so it holds at least MaxPeekBits
+        constexpr void refill()
+        {
+            if(!std::is_constant_evaluated()
+                && std::endian::native == std::endian::little
+                && m_NextByte + sizeof(value_type) <= m_Data.size())
+            {
+                // a single unaligned load, counting only the whole bytes that fit in the buffer. Any
+                // partial byte is loaded again next time
+                value_type word;
+                std::memcpy(&word, m_Data.data() + m_NextByte, sizeof(word));
+
+                auto const bytes = (BufferBits - m_Count) / CHAR_BIT;
+                m_Buffer |= word << m_Count;
+                m_NextByte += bytes;
+                m_Count += bytes * CHAR_BIT;
+                return;
+            }
+
+            while(m_Count <= BufferBits - CHAR_BIT) {
+                value_type const byte = m_NextByte < m_Data.size() ? m_Data[m_NextByte] : 0;
+                m_Buffer |= byte << m_Count;
+                ++m_NextByte;
+                m_Count += CHAR_BIT;
+            }
+        }
+
+        std::span<std::uint8_t const> m_Data{};
+        std::size_t m_NextByte{0};      // next byte to load into the buffer
+        value_type m_Buffer{0};         // bits not yet consumed, next bit in the least significant position
+        std::size_t m_Count{0};         // number of valid bits in the buffer
+    };
+
+}
+
+#endif //SQUEEZE_BIT_READER_H
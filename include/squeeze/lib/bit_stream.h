@@ -1,22 +1,40 @@
 #ifndef SQUEEZE_BIT_STREAM_H
 #define SQUEEZE_BIT_STREAM_H
 
+#include <algorithm>
 #include <climits>
 #include <cstdint>
 #include <array>
+#include <span>
+#include <type_traits>
 
 namespace squeeze::lib
 {
    //
    // A simple class to store a fixed number of bits and be able to access them
-   // by index
+   // by index, either one at a time or as runs of up to 64 bits.
    //
-   template<std::size_t NUM_BITS>
+   // Bits are stored in words of TStorage. Multi-bit values are packed with the first bit
+   // of the stream in the least significant position. Wider storage words mean fewer steps
+   // per bulk operation, byte storage keeps the size to the nearest byte.
+   //
+   template<std::size_t NUM_BITS, typename TStorage = std::uint8_t>
    class bit_stream
    {
+       static_assert(std::is_unsigned_v<TStorage>, "bit_stream storage must be an unsigned integer type");
+
    public:
+       using storage_type = TStorage;
+       using value_type = std::uint64_t;
+
+       // the most bits that can be moved by a single peek, read or write
+       constexpr static std::size_t MaxBulkBits = sizeof(value_type) * CHAR_BIT;
+
        constexpr std::size_t size() const { return NumBits; }
 
+       // the underlying storage words, for readers that access the bits directly
+       constexpr auto data() const { return std::span<storage_type const, NumStorageElements>{m_Storage}; }
+
        constexpr bit_stream()
        {
            // ensure we initialise all storage locations to satisfy constexpr context constraints
@@ -29,7 +47,7 @@ namespace squeeze::lib
            auto offset = idx / BitsPerStorageElement;
            auto bit = idx % BitsPerStorageElement;
 
-           storage_type mask = static_cast<storage_type>(1 << bit);
+           storage_type mask = static_cast<storage_type>(storage_type{1} << bit);
            m_Storage[offset] |= mask;
        }
 
@@ -39,7 +57,7 @@ namespace squeeze::lib
            auto offset = idx / BitsPerStorageElement;
            auto bit = idx % BitsPerStorageElement;
 
-           storage_type mask = static_cast<storage_type>(~(1 << bit));
+           storage_type mask = static_cast<storage_type>(~(storage_type{1} << bit));
            m_Storage[offset] &= mask;
        }
 
@@ -49,17 +67,73 @@ namespace squeeze::lib
            auto offset = idx / BitsPerStorageElement;
            auto bit = idx % BitsPerStorageElement;
 
-           storage_type mask = static_cast<storage_type>(1 << bit);
+           storage_type mask = static_cast<storage_type>(storage_type{1} << bit);
            return (m_Storage[offset] & mask) != 0;
        }
 
-   private:
-       using storage_type = std::uint8_t;
+       // Get count bits (up to MaxBulkBits) starting at pos without moving. The bit at pos is returned
+       // in the least significant position. Bits past the end of the stream read as zero.
+       constexpr value_type peek(std::size_t pos, std::size_t count) const
+       {
+           value_type result{0};
+           std::size_t done{0};
 
+           while(done < count) {
+               auto const offset = (pos + done) / BitsPerStorageElement;
+               auto const bit = (pos + done) % BitsPerStorageElement;
+               if(offset >= NumStorageElements) {
+                   break;
+               }
+
+               // take as many bits as are left in this storage element, or that we still need
+               auto const n = std::min(BitsPerStorageElement - bit, count - done);
+               auto const chunk = (static_cast<value_type>(m_Storage[offset]) >> bit) & mask(n);
+
+               result |= chunk << done;
+               done += n;
+           }
+
+           return result;
+       }
+
+       // Get count bits (up to MaxBulkBits) starting at pos, and move pos past them
+       constexpr value_type read(std::size_t &pos, std::size_t count) const
+       {
+           auto const result = peek(pos, count);
+           pos += count;
+           return result;
+       }
+
+       // Store the lowest count bits (up to MaxBulkBits) of value starting at pos. The least significant
+       // bit of value is stored at pos.
+       constexpr void write(std::size_t pos, value_type value, std::size_t count)
+       {
+           std::size_t done{0};
+
+           while(done < count) {
+               auto const offset = (pos + done) / BitsPerStorageElement;
+               auto const bit = (pos + done) % BitsPerStorageElement;
+
+               auto const n = std::min(BitsPerStorageElement - bit, count - done);
+               auto const m = static_cast<storage_type>(mask(n) << bit);
+               auto const bits = static_cast<storage_type>(((value >> done) << bit) & m);
+
+               m_Storage.at(offset) = static_cast<storage_type>((m_Storage.at(offset) & static_cast<storage_type>(~m)) | bits);
+               done += n;
+           }
+       }
+
+   private:
        constexpr static std::size_t BitsPerStorageElement = sizeof(storage_type) * CHAR_BIT;
        constexpr static std::size_t NumStorageElements = (NUM_BITS/BitsPerStorageElement) + (NUM_BITS%BitsPerStorageElement>0?1:0);
        constexpr static std::size_t NumBits = NUM_BITS;
 
+       // a value with the lowest n bits set
+       constexpr static value_type mask(std::size_t n)
+       {
+           return n >= MaxBulkBits ? ~value_type{0} : (value_type{1} << n) - 1;
+       }
+
        std::array<storage_type, NumStorageElements> m_Storage;
    };
 
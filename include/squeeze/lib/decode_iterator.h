@@ -0,0 +1,105 @@
+#ifndef SQUEEZE_DECODE_ITERATOR_H
+#define SQUEEZE_DECODE_ITERATOR_H
+
+#include <cstddef>
+#include <iterator>
+
+namespace squeeze::lib
+{
+    //
+    // An input iterator over a string that is decoded a character at a time, for encoders whose strings
+    // can't be indexed directly. TString provides the decode step:
+    //
+    //      TString::Cursor                 the decode state, default constructible
+    //      size()                          the number of characters in the string
+    //      start()                         the Cursor for the first character
+    //      next(Cursor &)                  decode the next character and advance the Cursor
+    //
+    // Iterators compare by character position, so an end iterator needs no decode state, and next() is
+    // never called past the end of the string. The strings only hold spans and decode state, not the
+    // table types, so one copy of each decoder serves every table.
+    //
+    template<typename TString>
+    class decode_iterator
+    {
+    private:
+        class ValueHolder
+        {
+        public:
+            constexpr explicit ValueHolder(char value) : m_Value(value) {}
+
+            constexpr char operator*() { return m_Value; }
+
+        private:
+            char m_Value;
+        };
+
+    public:
+        using value_type = char const;
+        using reference = char;
+        using iterator_category = std::input_iterator_tag;
+        using pointer = char const *;
+        using difference_type = void;
+
+        struct EndPosition{TString const &str;};
+
+        // used to construct a begin iterator
+        constexpr explicit decode_iterator(TString const &owner)
+            : m_Owner{owner}
+        {
+            // load the first character, an empty string is already the end iterator
+            if(!is_done()) {
+                m_Cursor = m_Owner.start();
+                m_Current = m_Owner.next(m_Cursor);
+            }
+        }
+
+        // used to construct an end iterator
+        constexpr explicit decode_iterator(EndPosition pos)
+            : m_Owner{pos.str}
+            , m_Position{pos.str.size()}
+        {}
+
+        constexpr reference operator*() const {
+            return m_Current;
+        }
+
+        constexpr pointer operator->() const {
+            return &m_Current;
+        }
+
+        constexpr decode_iterator &operator++() {
+            ++m_Position;
+            if(!is_done()) {
+                m_Current = m_Owner.next(m_Cursor);
+            }
+            return *this;
+        }
+
+        constexpr ValueHolder operator++(int) {
+            ValueHolder temp(**this);
+            ++*this;
+            return temp;
+        }
+
+        constexpr friend bool operator==(decode_iterator const &lhs, decode_iterator const &rhs) {
+            return lhs.m_Position == rhs.m_Position;
+        }
+
+    private:
+        [[nodiscard]] constexpr bool is_done() const
+        {
+            return m_Position >= m_Owner.size();
+        }
+
+        TString const &m_Owner;
+
+        // iteration state
+        typename TString::Cursor m_Cursor{};
+        char m_Current{'\0'};
+        std::size_t m_Position{0};
+    };
+
+}
+
+#endif //SQUEEZE_DECODE_ITERATOR_H
@@ -0,0 +1,94 @@
+#ifndef SQUEEZE_ELIAS_FANO_H
+#define SQUEEZE_ELIAS_FANO_H
+
+#include <bit>
+#include <cstdint>
+#include <array>
+
+#include "bit_stream.h"
+#include "smallest_uint.h"
+
+namespace squeeze::lib
+{
+    //
+    // Stores NUM_VALUES non-decreasing values, each no greater than MAX_VALUE, using Elias-Fano coding.
+    //
+    // Each value is split into LowBits low bits, stored packed, and the remaining high bits, stored in
+    // unary as a bit set at position (high + index). This takes about 2 + log2(MAX_VALUE / NUM_VALUES) bits
+    // per value. To find a value we select the index'th set bit of the high bits. The position of every
+    // SampleRate'th set bit is sampled so select only has to scan a short run of words.
+    //
+    template<std::size_t NUM_VALUES, std::uint64_t MAX_VALUE>
+    class elias_fano
+    {
+    public:
+        using value_type = std::uint64_t;
+
+        static constexpr std::size_t NumValues = NUM_VALUES;
+
+        // the number of low bits stored for each value, floor(log2(MAX_VALUE / NUM_VALUES))
+        static constexpr std::size_t LowBits = (NUM_VALUES == 0 || MAX_VALUE <= NUM_VALUES) ? 0 : bits_needed(MAX_VALUE / NUM_VALUES) - 1;
+
+        // the positions of one in every SampleRate set high bits are sampled
+        static constexpr std::size_t SampleRate = 64;
+
+        // get the value at idx
+        constexpr value_type operator[](std::size_t idx) const
+        {
+            auto const high = select(idx) - idx;
+            return (high << LowBits) | m_Low.peek(idx * LowBits, LowBits);
+        }
+
+        // store the value at idx. Values must be stored in increasing index order.
+        constexpr void set(std::size_t idx, value_type value)
+        {
+            m_Low.write(idx * LowBits, value, LowBits);
+
+            auto const position = (value >> LowBits) + idx;
+            m_High.set(position);
+
+            if(idx % SampleRate == 0) {
+                m_Samples.at(idx / SampleRate) = static_cast<SampleType>(position);
+            }
+        }
+
+    private:
+        static constexpr std::size_t NumHighBits = NUM_VALUES + (MAX_VALUE >> LowBits) + 1;
+        static constexpr std::size_t NumSamples = (NUM_VALUES + SampleRate - 1) / SampleRate;
+        static constexpr std::size_t WordBits = bit_stream<NumHighBits, std::uint64_t>::MaxBulkBits;
+
+        using SampleType = smallest_uint_t<NumHighBits>;
+
+        // find the position of the idx'th set bit in the high bits
+        constexpr std::size_t select(std::size_t idx) const
+        {
+            // start from the sampled set bit at or before the one we want, and count the rest
+            std::size_t position = m_Samples[idx / SampleRate];
+            auto remaining = idx % SampleRate;
+
+            // look at a word at a time, ignoring bits before the sampled one
+            for(;;) {
+                auto const word = m_High.peek(position, WordBits);
+                auto const count = static_cast<std::size_t>(std::popcount(word));
+
+                if(remaining < count) {
+                    // the bit is in this word, so clear the set bits before it
+                    auto bits = word;
+                    for(; remaining > 0; --remaining) {
+                        bits &= bits - 1;
+                    }
+                    return position + static_cast<std::size_t>(std::countr_zero(bits));
+                }
+
+                remaining -= count;
+                position += WordBits;
+            }
+        }
+
+        bit_stream<NUM_VALUES * LowBits> m_Low;
+        bit_stream<NumHighBits, std::uint64_t> m_High;
+        std::array<SampleType, NumSamples> m_Samples{};
+    };
+}
+
+#endif //SQUEEZE_ELIAS_FANO_H
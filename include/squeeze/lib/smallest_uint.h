@@ -0,0 +1,36 @@
+#ifndef SQUEEZE_SMALLEST_UINT_H
+#define SQUEEZE_SMALLEST_UINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace squeeze::lib
+{
+    //
+    // The narrowest unsigned integer type that can hold every value from 0 to MAX_VALUE.
+    // Used to size tables at compile time, so small tables don't pay for 64 bit fields.
+    //
+    template<std::uint64_t MAX_VALUE>
+    using smallest_uint_t =
+        std::conditional_t<MAX_VALUE <= std::numeric_limits<std::uint8_t>::max(), std::uint8_t,
+        std::conditional_t<MAX_VALUE <= std::numeric_limits<std::uint16_t>::max(), std::uint16_t,
+        std::conditional_t<MAX_VALUE <= std::numeric_limits<std::uint32_t>::max(), std::uint32_t,
+        std::uint64_t>>>;
+
+    //
+    // The number of bits needed to store every value from 0 to maxValue. 0 needs no bits.
+    //
+    constexpr std::size_t bits_needed(std::uint64_t maxValue)
+    {
+        std::size_t bits{0};
+        while(bits < std::numeric_limits<std::uint64_t>::digits && (maxValue >> bits) != 0) {
+            ++bits;
+        }
+
+        return bits;
+    }
+}
+
+#endif //SQUEEZE_SMALLEST_UINT_H
@@ -0,0 +1,71 @@
+#ifndef SQUEEZE_SUFFIX_OWNERS_H
+#define SQUEEZE_SUFFIX_OWNERS_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+
+namespace squeeze::lib
+{
+    //
+    // For each of NUM_STRINGS strings, the index of the string whose stored copy it can be read from the end
+    // of. Identical strings and strings that are a suffix of another share its storage, so only the strings
+    // that are their own owner need to be stored. Of identical strings, the one with the lowest index is stored.
+    //
+    // canMerge(i) says whether string i can hold, or be held in, a string other than its duplicates.
+    //
+    // Strings are sorted by their reversed characters, so a string that is the suffix of any other is the
+    // suffix of the one following it.
+    //
+    template<std::size_t NUM_STRINGS>
+    constexpr std::array<std::size_t, NUM_STRINGS> suffix_owners(auto const &strings, auto canMerge)
+    {
+        std::array<std::string_view, NUM_STRINGS> views{};
+        std::array<std::size_t, NUM_STRINGS> order{};
+
+        std::size_t n{0};
+        for(auto const &s : strings) {
+            views.at(n) = std::string_view{s};
+            order.at(n) = n;
+            ++n;
+        }
+
+        std::sort(order.begin(), order.end(), [&](std::size_t lhs, std::size_t rhs) {
+            auto const &l = views[lhs];
+            auto const &r = views[rhs];
+            if(l == r) {
+                return lhs > rhs;
+            }
+            return std::lexicographical_compare(l.rbegin(), l.rend(), r.rbegin(), r.rend());
+        });
+
+        std::array<std::size_t, NUM_STRINGS> owners{};
+        for(std::size_t k{NUM_STRINGS}; k-- > 0;) {
+            auto const idx = order[k];
+            owners.at(idx) = idx;
+
+            if(k + 1 == NUM_STRINGS) {
+                continue;
+            }
+
+            auto const &s = views[idx];
+            auto const owner = owners[order[k + 1]];
+            auto const &o = views[owner];
+            if(s == o || (canMerge(idx) && canMerge(owner) && o.ends_with(s))) {
+                owners.at(idx) = owner;
+            }
+        }
+
+        return owners;
+    }
+
+    template<std::size_t NUM_STRINGS>
+    constexpr std::array<std::size_t, NUM_STRINGS> suffix_owners(auto const &strings)
+    {
+        return suffix_owners<NUM_STRINGS>(strings, [](std::size_t) { return true; });
+    }
+}
+
+#endif //SQUEEZE_SUFFIX_OWNERS_H
@@ -0,0 +1,799 @@
+#ifndef SQUEEZE_LOOKUP_H
+#define SQUEEZE_LOOKUP_H
+
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <bit>
+#include <numeric>
+#include <string_view>
+#include <type_traits>
+
+#include "concepts.h"
+#include "lib/bit_stream.h"
+#include "lib/smallest_uint.h"
+
+namespace squeeze
+{
+    namespace lookup {
+
+        // returned by find() when a key is not in the map
+        constexpr std::size_t NotFound = std::numeric_limits<std::size_t>::max();
+
+        // The result of finding a key in a StringMap: the index of its string, or NotFound
+        struct Handle
+        {
+            std::size_t Index{NotFound};
+
+            constexpr explicit operator bool() const { return Index != NotFound; }
+        };
+
+        // Maps a key to the index of its string in the encoded data
+        template<typename TKey>
+        struct KeyMap
+        {
+            TKey Key;
+            std::size_t Index;
+        };
+
+        // Get the bits of an integer or enum key, for hashing
+        template<typename TKey>
+        constexpr std::uint64_t KeyBits(TKey key)
+        {
+            if constexpr (std::is_enum_v<TKey>) {
+                return static_cast<std::uint64_t>(static_cast<std::underlying_type_t<TKey>>(key));
+            } else {
+                return static_cast<std::uint64_t>(key);
+            }
+        }
+
+        // The keys with the index of their string, sorted by key with the first string for each key
+        // ahead of any duplicates
+        template<typename TKey>
+        constexpr auto SortedKeys(CallableGivesIterableKeyedStringViews<TKey> auto makeStringsLambda)
+        {
+            constexpr auto map = makeStringsLambda();
+            constexpr auto NumStrings = std::distance(map.begin(), map.end());
+
+            std::array<KeyMap<TKey>, NumStrings> keys;
+
+            std::size_t idx{0};
+            for(auto const &v : map) {
+                keys.at(idx) = KeyMap<TKey>{v.Key, idx};
+                ++idx;
+            }
+            std::sort(keys.begin(), keys.end(), [](auto const &a, auto const &b) {
+                return a.Key != b.Key ? a.Key < b.Key : a.Index < b.Index;
+            });
+
+            return keys;
+        }
+
+        // The number of distinct keys in the result of SortedKeys()
+        template<typename TKey, std::size_t NUM_ENTRIES>
+        constexpr std::size_t CountDistinctKeys(std::array<KeyMap<TKey>, NUM_ENTRIES> const &sorted)
+        {
+            std::size_t count{0};
+            for(std::size_t i{0}; i < NUM_ENTRIES; ++i) {
+                if(i == 0 || sorted.at(i).Key != sorted.at(i - 1).Key) {
+                    ++count;
+                }
+            }
+            return count;
+        }
+
+        // The first entry for each distinct key in the result of SortedKeys()
+        template<std::size_t NUM_KEYS, typename TKey, std::size_t NUM_ENTRIES>
+        constexpr auto DistinctKeys(std::array<KeyMap<TKey>, NUM_ENTRIES> const &sorted)
+        {
+            std::array<KeyMap<TKey>, NUM_KEYS> keys;
+
+            std::size_t count{0};
+            for(std::size_t i{0}; i < NUM_ENTRIES; ++i) {
+                if(i == 0 || sorted.at(i).Key != sorted.at(i - 1).Key) {
+                    keys.at(count++) = sorted.at(i);
+                }
+            }
+
+            return keys;
+        }
+
+        // The entries of the map sorted by key, keeping the order of entries with the same key
+        template<typename TKey>
+        constexpr auto SortByKey(CallableGivesIterableKeyedStringViews<TKey> auto makeStringsLambda) -> CallableGivesIterableKeyedStringViews<TKey> auto
+        {
+            return [=]() {
+                constexpr auto map = makeStringsLambda();
+                constexpr auto sorted = SortedKeys<TKey>(makeStringsLambda);
+
+                std::array<KeyedStringView<TKey>, sorted.size()> result;
+                for(std::size_t i{0}; i < sorted.size(); ++i) {
+                    result.at(i) = *std::next(map.begin(), static_cast<std::ptrdiff_t>(sorted.at(i).Index));
+                }
+                return result;
+            };
+        }
+
+        // Lookup policies that store no string indexes set SortsStrings, so the map's strings are stored
+        // in key order and the index of a key's string is its position in the sorted keys.
+        template<typename TLookup>
+        constexpr bool SortsStrings = requires { requires TLookup::SortsStrings; };
+
+        // The keys of the map as a list of strings, in the same order as the strings, so they can be
+        // stored with the map's encoder
+        template<typename TKey>
+        constexpr auto MapToKeys(CallableGivesIterableKeyedStringViews<TKey> auto makeStringsLambda) -> CallableGivesIterableStringViews auto
+        {
+            return [=]() {
+                constexpr auto map = makeStringsLambda();
+                constexpr auto NumStrings = std::distance(map.begin(), map.end());
+
+                std::array<std::string_view, NumStrings> result;
+                std::size_t idx{0};
+                for(auto const &v : map) {
+                    result.at(idx++) = v.Key;
+                }
+                return result;
+            };
+        }
+
+        // Determine if a string returned by an encoder holds the same characters as the key
+        template<typename TString>
+        constexpr bool Equal(TString const &str, std::string_view key)
+        {
+            return str.size() == key.size() && std::equal(key.begin(), key.end(), str.begin());
+        }
+
+        // A 64 bit hash of a key for the perfect hash. The bits of integer and enum keys are used as they are,
+        // strings are hashed with FNV-1a.
+        template<typename TKey>
+        constexpr std::uint64_t KeyHashBits(TKey const &key)
+        {
+            if constexpr (std::is_same_v<TKey, std::string_view>) {
+                std::uint64_t hash{0xCBF2'9CE4'8422'2325ull};
+                for(auto const c : key) {
+                    hash = (hash ^ static_cast<std::uint8_t>(c)) * 0x0000'0100'0000'01B3ull;
+                }
+                return hash;
+            } else {
+                return KeyBits(key);
+            }
+        }
+
+        // Hint that the memory at p will be read soon. Does nothing at compile time, or without compiler support.
+        template<typename T>
+        constexpr void Prefetch([[maybe_unused]] T const *p)
+        {
+            if(!std::is_constant_evaluated()) {
+#if defined(__GNUC__) || defined(__clang__)
+                __builtin_prefetch(p);
+#endif
+            }
+        }
+
+        // A 64 bit mixing function (the splitmix64 finaliser), so every input bit affects every output bit
+        constexpr std::uint64_t Mix(std::uint64_t x)
+        {
+            x += 0x9E37'79B9'7F4A'7C15ull;
+            x = (x ^ (x >> 30)) * 0xBF58'476D'1CE4'E5B9ull;
+            x = (x ^ (x >> 27)) * 0x94D0'49BB'1331'11EBull;
+            return x ^ (x >> 31);
+        }
+
+        // The perfect hash puts each key in a bucket, then moves it to its slot using the pilot value
+        // found for the bucket at compile time.
+        constexpr std::uint64_t Hash(std::uint64_t keyBits, std::uint64_t seed) { return Mix(keyBits ^ seed); }
+        constexpr std::size_t Bucket(std::uint64_t hash, std::size_t numBuckets) { return (hash >> 32) % numBuckets; }
+        // The pilot is mixed in before taking the slot, so it changes the low bits of keys in the same bucket
+        // differently. Otherwise two keys whose hashes differ only in their high bits could never be separated.
+        constexpr std::size_t Slot(std::uint64_t hash, std::uint64_t pilot, std::size_t numSlots) { return Mix(hash ^ pilot) % numSlots; }
+
+        // The result of searching for a minimal perfect hash of NUM_KEYS keys
+        template<std::size_t NUM_KEYS, std::size_t NUM_BUCKETS>
+        struct PerfectHash
+        {
+            bool Found{false};
+            std::uint64_t Seed{0};
+            std::uint64_t MaxPilot{0};
+            std::array<std::uint64_t, NUM_BUCKETS> Pilots{};
+            std::array<std::size_t, NUM_KEYS> Slots{};      // the slot of each key
+        };
+
+        //
+        // Search for a minimal perfect hash of the distinct keys, PTHash style.
+        //
+        // Keys are hashed into buckets. Taking the largest buckets first, we search for the smallest pilot
+        // value that moves all the keys in the bucket into free slots. If a bucket can't be placed, we try
+        // again with a different seed. Found is false if every seed fails.
+        //
+        template<std::size_t NUM_KEYS, std::size_t NUM_BUCKETS>
+        constexpr auto BuildPerfectHash(std::array<std::uint64_t, NUM_KEYS> const &keys)
+        {
+            constexpr std::size_t MaxSeeds = 32;
+            constexpr std::uint64_t MaxPilot = 1u << 16;
+
+            PerfectHash<NUM_KEYS, NUM_BUCKETS> result{};
+
+            for(std::size_t attempt{0}; attempt < MaxSeeds && !result.Found; ++attempt) {
+                result.Seed = Mix(attempt);
+                result.MaxPilot = 0;
+
+                std::array<std::uint64_t, NUM_KEYS> hashes{};
+                std::array<std::size_t, NUM_BUCKETS + 1> bucketStart{};
+                for(std::size_t i{0}; i < NUM_KEYS; ++i) {
+                    hashes.at(i) = Hash(keys.at(i), result.Seed);
+                    ++bucketStart.at(Bucket(hashes.at(i), NUM_BUCKETS) + 1);
+                }
+
+                // group the keys by bucket
+                std::partial_sum(bucketStart.begin(), bucketStart.end(), bucketStart.begin());
+                std::array<std::size_t, NUM_KEYS> members{};
+                auto next = bucketStart;
+                for(std::size_t i{0}; i < NUM_KEYS; ++i) {
+                    members.at(next.at(Bucket(hashes.at(i), NUM_BUCKETS))++) = i;
+                }
+
+                // place the largest buckets first, as they are the hardest to fit
+                std::array<std::size_t, NUM_BUCKETS> order{};
+                std::iota(order.begin(), order.end(), std::size_t{0});
+                std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+                    auto const sizeA = bucketStart.at(a + 1) - bucketStart.at(a);
+                    auto const sizeB = bucketStart.at(b + 1) - bucketStart.at(b);
+                    return sizeA != sizeB ? sizeA > sizeB : a < b;
+                });
+
+                std::array<bool, NUM_KEYS> taken{};
+                bool placedAll{true};
+
+                for(auto const bucket : order) {
+                    auto const first = bucketStart.at(bucket);
+                    auto const last = bucketStart.at(bucket + 1);
+                    if(first == last) {
+                        break;  // the rest are empty
+                    }
+
+                    bool placed{false};
+                    for(std::uint64_t pilot{0}; pilot < MaxPilot && !placed; ++pilot) {
+                        placed = true;
+                        for(std::size_t m{first}; m < last && placed; ++m) {
+                            auto const slot = Slot(hashes.at(members.at(m)), pilot, NUM_KEYS);
+                            placed = !taken.at(slot);
+
+                            // keys of the same bucket must not share a slot either
+                            for(std::size_t o{first}; o < m && placed; ++o) {
+                                placed = slot != result.Slots.at(members.at(o));
+                            }
+
+                            result.Slots.at(members.at(m)) = slot;
+                        }
+
+                        if(placed) {
+                            for(std::size_t m{first}; m < last; ++m) {
+                                taken.at(result.Slots.at(members.at(m))) = true;
+                            }
+                            result.Pilots.at(bucket) = pilot;
+                            result.MaxPilot = std::max(result.MaxPilot, pilot);
+                        }
+                    }
+
+                    if(!placed) {
+                        placedAll = false;
+                        break;
+                    }
+                }
+
+                result.Found = placedAll;
+            }
+
+            return result;
+        }
+    }
+
+
+    //
+    // Finds keys with a binary search over the keys sorted at compile time.
+    //
+    class SortedLookup
+    {
+    public:
+        template<typename TKey, std::size_t NUM_ENTRIES>
+        struct Data
+        {
+            using KeyMapType = lookup::KeyMap<TKey>;
+
+            // get the index of the string for the key, or lookup::NotFound
+            constexpr std::size_t find(TKey key) const
+            {
+                // finds the first entry that is no less than the key. May be end(), or higher than the key
+                auto entry = std::lower_bound(
+                        m_Lookup.begin(), m_Lookup.end(), key,
+                        [](auto const &e, auto const& v){return e.Key < v;}
+                );
+
+                if(entry == m_Lookup.end() || (*entry).Key != key) {  // could be larger key value
+                    return lookup::NotFound;
+                }
+
+                return (*entry).Index;
+            }
+
+            std::array<KeyMapType, NUM_ENTRIES> m_Lookup;
+        };
+
+        template<typename TKey, typename TEncoder>
+        static constexpr auto Compile(CallableGivesIterableKeyedStringViews<TKey> auto makeStringsLambda)
+        {
+            constexpr auto map = makeStringsLambda();
+            constexpr auto NumStrings = std::distance(map.begin(), map.end());
+
+            // build the lookup for key->index mapping
+            Data<TKey, NumStrings> result;
+
+            std::size_t idx{0};
+            for(auto const &v : map) {
+                result.m_Lookup.at(idx).Key = v.Key;
+                result.m_Lookup.at(idx).Index = idx;
+                ++idx;
+            }
+            // ensure it is sorted by key for searching
+            std::sort(result.m_Lookup.begin(), result.m_Lookup.end(), [](auto &a, auto &b) { return a.Key < b.Key;});
+
+            return result;
+        }
+    };
+
+
+    //
+    // Finds keys with a branchless binary search over the keys stored in Eytzinger (breadth first) order,
+    // so the keys compared in the first few steps of every search share cache lines. Each step is a compare
+    // and a shift with no data-dependent branch, then a single compare verifies the key found. For large
+    // key sets, the cache line needed a few steps ahead is prefetched while the current step runs.
+    //
+    // Only the keys and string indexes are stored, so this suits large sparse key sets where the
+    // metadata of a PerfectHashLookup would not pay for itself. If the same key appears more than
+    // once, the first is used.
+    //
+    class EytzingerLookup
+    {
+    public:
+        template<typename TKey, std::size_t NUM_KEYS, typename TIndex>
+        struct Data
+        {
+            // the descendants of node k, log2(KeysPerLine) levels down, start at node k * KeysPerLine and fill
+            // a cache line. Only worth fetching them early when the keys don't all stay in the cache.
+            static constexpr std::size_t CacheLineBytes = 64;
+            static constexpr std::size_t KeysPerLine = std::bit_floor(std::max(CacheLineBytes / sizeof(TKey), std::size_t{1}));
+            static constexpr bool UsePrefetch = KeysPerLine > 1 && (NUM_KEYS + 1) * sizeof(TKey) > 16 * CacheLineBytes;
+
+            // get the index of the string for the key, or lookup::NotFound
+            constexpr std::size_t find(TKey key) const
+            {
+                // walk down the tree to the leaf below the first key that is no less than the key
+                std::size_t k{1};
+                while(k <= NUM_KEYS) {
+                    if constexpr (UsePrefetch) {
+                        lookup::Prefetch(m_Keys.data() + std::min(k * KeysPerLine, NUM_KEYS));
+                    }
+                    k = 2 * k + static_cast<std::size_t>(m_Keys[k] < key);
+                }
+
+                // climb back up past the right turns to that key. 0 if every key is less.
+                k >>= std::countr_one(k) + 1;
+
+                return k != 0 && m_Keys[k] == key ? m_Indices[k] : lookup::NotFound;
+            }
+
+            // 1 based, the children of node k are 2k and 2k+1. Slot 0 is unused.
+            alignas(UsePrefetch ? CacheLineBytes : alignof(TKey)) std::array<TKey, NUM_KEYS + 1> m_Keys;
+            std::array<TIndex, NUM_KEYS + 1> m_Indices;
+        };
+
+        template<typename TKey, typename TEncoder>
+        static constexpr auto Compile(CallableGivesIterableKeyedStringViews<TKey> auto makeStringsLambda)
+        {
+            constexpr auto sorted = lookup::SortedKeys<TKey>(makeStringsLambda);
+            constexpr auto NumKeys = lookup::CountDistinctKeys(sorted);
+            constexpr auto keys = lookup::DistinctKeys<NumKeys>(sorted);
+
+            using IndexType = lib::smallest_uint_t<sorted.size()>;
+            Data<TKey, NumKeys, IndexType> result{};
+
+            // an in-order walk of the tree visits the nodes in sorted order
+            std::size_t next{0};
+            auto const fill = [&](auto const &self, std::size_t k) -> void {
+                if(k > NumKeys) {
+                    return;
+                }
+                self(self, 2 * k);
+                result.m_Keys.at(k) = keys.at(next).Key;
+                result.m_Indices.at(k) = static_cast<IndexType>(keys.at(next).Index);
+                ++next;
+                self(self, 2 * k + 1);
+            };
+            fill(fill, 1);
+
+            return result;
+        }
+    };
+
+    //
+    // Finds keys with a minimal perfect hash built at compile time. A lookup is a hash, a load of
+    // the bucket's pilot value and a single compare to verify the key in the slot it gives.
+    //
+    // Integer, enum and std::string_view keys. String keys are stored with the map's encoder, so they
+    // are compressed along with the strings, and verifying a key decodes it while comparing. If the same
+    // key appears more than once, the first is used. If no perfect hash can be found, which is very
+    // unlikely, it falls back to a SortedLookup.
+    //
+    class PerfectHashLookup
+    {
+    public:
+        template<typename TKey, std::size_t NUM_KEYS, std::size_t NUM_BUCKETS, typename TPilot, typename TIndex, typename TKeyStore>
+        struct Data
+        {
+            // String keys are stored in the order of the strings, other keys in the order of the slots
+            static constexpr bool IsStringKey = std::is_same_v<TKey, std::string_view>;
+
+            // get the index of the string for the key, or lookup::NotFound
+            constexpr std::size_t find(TKey key) const
+            {
+                if constexpr (NUM_KEYS == 0) {
+                    return lookup::NotFound;
+                } else {
+                    auto const hash = lookup::Hash(lookup::KeyHashBits(key), m_Seed);
+                    auto const slot = lookup::Slot(hash, m_Pilots[lookup::Bucket(hash, NUM_BUCKETS)], NUM_KEYS);
+
+                    if constexpr (IsStringKey) {
+                        std::size_t const index = m_Indices[slot];
+                        return lookup::Equal(m_Keys[index], key) ? index : lookup::NotFound;
+                    } else {
+                        return m_Keys[slot] == key ? m_Indices[slot] : lookup::NotFound;
+                    }
+                }
+            }
+
+            std::uint64_t m_Seed;
+            std::array<TPilot, NUM_BUCKETS> m_Pilots;
+            TKeyStore m_Keys;                           // the key in each slot, or of each string
+            std::array<TIndex, NUM_KEYS> m_Indices;     // the index of the string for the key in each slot
+        };
+
+        template<typename TKey, typename TEncoder>
+        static constexpr auto Compile(CallableGivesIterableKeyedStringViews<TKey> auto makeStringsLambda)
+        {
+            constexpr auto map = makeStringsLambda();
+            constexpr auto NumStrings = std::distance(map.begin(), map.end());
+
+            constexpr auto sorted = lookup::SortedKeys<TKey>(makeStringsLambda);
+            constexpr auto NumKeys = lookup::CountDistinctKeys(sorted);
+            constexpr auto keys = lookup::DistinctKeys<NumKeys>(sorted);
+
+            constexpr auto NumBuckets = NumKeys / 4 + 1;
+
+            constexpr auto hash = [=]() {
+                std::array<std::uint64_t, NumKeys> bits{};
+                for(std::size_t i{0}; i < NumKeys; ++i) {
+                    bits.at(i) = lookup::KeyHashBits(keys.at(i).Key);
+                }
+                return lookup::BuildPerfectHash<NumKeys, NumBuckets>(bits);
+            }();
+
+            if constexpr (!hash.Found) {
+                return SortedLookup::Compile<TKey, TEncoder>(makeStringsLambda);
+            } else {
+                using PilotType = lib::smallest_uint_t<hash.MaxPilot>;
+                using IndexType = lib::smallest_uint_t<NumStrings>;
+
+                auto const keyStore = [=]() {
+                    if constexpr (std::is_same_v<TKey, std::string_view>) {
+                        return TEncoder::Compile(lookup::MapToKeys<TKey>(makeStringsLambda));
+                    } else {
+                        std::array<TKey, NumKeys> slotKeys{};
+                        for(std::size_t i{0}; i < NumKeys; ++i) {
+                            slotKeys.at(hash.Slots.at(i)) = keys.at(i).Key;
+                        }
+                        return slotKeys;
+                    }
+                }();
+
+                Data<TKey, NumKeys, NumBuckets, PilotType, IndexType, decltype(keyStore)> result{hash.Seed, {}, keyStore, {}};
+
+                for(std::size_t b{0}; b < NumBuckets; ++b) {
+                    result.m_Pilots.at(b) = static_cast<PilotType>(hash.Pilots.at(b));
+                }
+                for(std::size_t i{0}; i < NumKeys; ++i) {
+                    result.m_Indices.at(hash.Slots.at(i)) = static_cast<IndexType>(keys.at(i).Index);
+                }
+
+                return result;
+            }
+        }
+    };
+
+
+    //
+    // Finds keys with a binary search over the keys stored bit-packed in key order, as offsets from the
+    // smallest key at the fewest bits that hold the largest. The map's strings are sorted by key, so the
+    // position of a key is the index of its string and no indexes are stored. The first key of every
+    // SampleRate is sampled at full width, so the search starts in a small array and ends in one block.
+    //
+    // Suits large sparse integer or enum key sets. Other keys fall back to a SortedLookup. If the same key
+    // appears more than once, the first is used.
+    //
+    class PackedLookup
+    {
+    public:
+        static constexpr bool SortsStrings = true;
+
+        template<typename TKey, std::uint64_t MIN_KEY_BITS, std::uint64_t MAX_OFFSET, std::size_t NUM_KEYS>
+        struct Data
+        {
+            static constexpr std::size_t BitsPerKey = lib::bits_needed(MAX_OFFSET);
+            static constexpr std::size_t SampleRate = 64;
+            static constexpr std::size_t NumSamples = (NUM_KEYS + SampleRate - 1) / SampleRate;
+
+            using SampleType = lib::smallest_uint_t<MAX_OFFSET>;
+
+            // get the index of the string for the key, or lookup::NotFound
+            constexpr std::size_t find(TKey key) const
+            {
+                // keys below the smallest wrap around to a large offset, so one compare checks both ends
+                auto const offset = lookup::KeyBits(key) - MIN_KEY_BITS;
+                if(offset > MAX_OFFSET) {
+                    return lookup::NotFound;
+                }
+
+                // the first key no less than the offset follows the last sample that is less than it
+                auto const less = static_cast<std::size_t>(std::lower_bound(m_Samples.begin(), m_Samples.end(), offset) - m_Samples.begin());
+                std::size_t first = less == 0 ? 0 : (less - 1) * SampleRate + 1;
+                std::size_t count = std::min(less * SampleRate, NUM_KEYS) - first;
+
+                while(count > 0) {
+                    auto const half = count / 2;
+                    if(key_at(first + half) < offset) {
+                        first += half + 1;
+                        count -= half + 1;
+                    } else {
+                        count = half;
+                    }
+                }
+
+                return first < NUM_KEYS && key_at(first) == offset ? first : lookup::NotFound;
+            }
+
+            // the offset from the smallest key of the key at idx
+            constexpr std::uint64_t key_at(std::size_t idx) const
+            {
+                return m_Keys.peek(idx * BitsPerKey, BitsPerKey);
+            }
+
+            lib::bit_stream<NUM_KEYS * BitsPerKey> m_Keys;
+            std::array<SampleType, NumSamples> m_Samples;
+        };
+
+        template<typename TKey, typename TEncoder>
+        static constexpr auto Compile(CallableGivesIterableKeyedStringViews<TKey> auto makeStringsLambda)
+        {
+            constexpr auto sorted = lookup::SortedKeys<TKey>(makeStringsLambda);
+
+            if constexpr ((!std::is_integral_v<TKey> && !std::is_enum_v<TKey>) || sorted.size() == 0) {
+                return SortedLookup::Compile<TKey, TEncoder>(makeStringsLambda);
+            } else {
+                static_assert(
+                    [=]() {
+                        for(std::size_t i{0}; i < sorted.size(); ++i) {
+                            if(sorted.at(i).Index != i) {
+                                return false;
+                            }
+                        }
+                        return true;
+                    }(),
+                    "PackedLookup needs the strings sorted by key");
+
+                constexpr auto MinKeyBits = lookup::KeyBits(sorted.front().Key);
+                constexpr auto MaxOffset = lookup::KeyBits(sorted.back().Key) - MinKeyBits;
+
+                using DataType = Data<TKey, MinKeyBits, MaxOffset, sorted.size()>;
+                DataType result{};
+
+                for(std::size_t i{0}; i < sorted.size(); ++i) {
+                    auto const offset = lookup::KeyBits(sorted.at(i).Key) - MinKeyBits;
+                    result.m_Keys.write(i * DataType::BitsPerKey, offset, DataType::BitsPerKey);
+
+                    if(i % DataType::SampleRate == 0) {
+                        result.m_Samples.at(i / DataType::SampleRate) = static_cast<typename DataType::SampleType>(offset);
+                    }
+                }
+
+                return result;
+            }
+        }
+    };
+
+
+    //
+    // Finds the range holding a key, with a binary search over the low key of each range sorted at compile
+    // time, then a compare with the high key of the range found. The strings are stored in the order of the
+    // ranges, so the position of a range is the index of its string.
+    //
+    // Used by StringRangeMap. The ranges must not overlap.
+    //
+    class RangeLookup
+    {
+    public:
+        template<typename TKey, std::size_t NUM_RANGES>
+        struct Data
+        {
+            // get the index of the string for the range holding the key, or lookup::NotFound
+            constexpr std::size_t find(TKey key) const
+            {
+                // the range after the one that may hold the key
+                auto const next = std::upper_bound(m_Lows.begin(), m_Lows.end(), key);
+                if(next == m_Lows.begin()) {     // below the first range
+                    return lookup::NotFound;
+                }
+
+                auto const idx = static_cast<std::size_t>(next - m_Lows.begin()) - 1;
+                return key <= m_Highs[idx] ? idx : lookup::NotFound;
+            }
+
+            std::array<TKey, NUM_RANGES> m_Lows;
+            std::array<TKey, NUM_RANGES> m_Highs;
+        };
+
+        // The ranges sorted by their low key
+        template<typename TKey>
+        static constexpr auto SortRanges(CallableGivesIterableKeyedRangeStringViews<TKey> auto makeRangesLambda)
+        {
+            return [=]() {
+                constexpr auto ranges = makeRangesLambda();
+                constexpr auto NumRanges = std::distance(ranges.begin(), ranges.end());
+
+                std::array<KeyedRangeStringView<TKey>, NumRanges> result;
+                std::copy(ranges.begin(), ranges.end(), result.begin());
+                std::sort(result.begin(), result.end(), [](auto const &a, auto const &b) { return a.Low < b.Low; });
+                return result;
+            };
+        }
+
+        // The strings of the ranges in the order given
+        template<typename TKey>
+        static constexpr auto RangesToStrings(CallableGivesIterableKeyedRangeStringViews<TKey> auto makeRangesLambda) -> CallableGivesIterableStringViews auto
+        {
+            return [=]() {
+                constexpr auto ranges = makeRangesLambda();
+                constexpr auto NumRanges = std::distance(ranges.begin(), ranges.end());
+
+                std::array<std::string_view, NumRanges> result;
+                std::size_t idx{0};
+                for(auto const &r : ranges) {
+                    result.at(idx++) = r.Value;
+                }
+                return result;
+            };
+        }
+
+        // Build the lookup for ranges already sorted by SortRanges()
+        template<typename TKey>
+        static constexpr auto Compile(CallableGivesIterableKeyedRangeStringViews<TKey> auto makeRangesLambda)
+        {
+            constexpr auto ranges = makeRangesLambda();
+            constexpr auto NumRanges = std::distance(ranges.begin(), ranges.end());
+
+            static_assert(
+                [=]() {
+                    for(auto it = ranges.begin(); it != ranges.end(); ++it) {
+                        if((*it).High < (*it).Low) {
+                            return false;
+                        }
+                        if(it != ranges.begin() && !((*std::prev(it)).High < (*it).Low)) {
+                            return false;
+                        }
+                    }
+                    return true;
+                }(),
+                "StringRangeMap ranges must have Low <= High and must not overlap");
+
+            Data<TKey, NumRanges> result{};
+
+            std::size_t idx{0};
+            for(auto const &r : ranges) {
+                result.m_Lows.at(idx) = r.Low;
+                result.m_Highs.at(idx) = r.High;
+                ++idx;
+            }
+
+            return result;
+        }
+    };
+
+
+    //
+    // Finds keys by indexing an array covering every key from the smallest to the largest, holding the
+    // index of the string for each key or a sentinel where there is no string. A lookup is a subtract,
+    // a compare and a single load.
+    //
+    // Used when at least MIN_DENSITY_PERCENT of the keys in that range are present, which is typical of
+    // enums. Otherwise, or for keys that aren't integers or enums, it falls back to a SortedLookup. If the
+    // same key appears more than once, the first is used.
+    //
+    template<std::size_t MIN_DENSITY_PERCENT = 50>
+    class BasicDenseLookup
+    {
+        static_assert(MIN_DENSITY_PERCENT > 0 && MIN_DENSITY_PERCENT <= 100, "Density must be 1 to 100 percent");
+
+    public:
+        template<typename TKey, std::uint64_t MIN_KEY_BITS, std::size_t NUM_SLOTS, typename TIndex>
+        struct Data
+        {
+            // marks a slot with no string
+            static constexpr TIndex Empty = std::numeric_limits<TIndex>::max();
+
+            // get the index of the string for the key, or lookup::NotFound
+            constexpr std::size_t find(TKey key) const
+            {
+                // keys below the smallest wrap around to a large offset, so one compare checks both ends
+                auto const offset = lookup::KeyBits(key) - MIN_KEY_BITS;
+                if(offset >= NUM_SLOTS || m_Indices[offset] == Empty) {
+                    return lookup::NotFound;
+                }
+
+                return m_Indices[offset];
+            }
+
+            std::array<TIndex, NUM_SLOTS> m_Indices;    // the index of the string for each key, or Empty
+        };
+
+        template<typename TKey, typename TEncoder>
+        static constexpr auto Compile(CallableGivesIterableKeyedStringViews<TKey> auto makeStringsLambda)
+        {
+            if constexpr (!std::is_integral_v<TKey> && !std::is_enum_v<TKey>) {
+                return SortedLookup::Compile<TKey, TEncoder>(makeStringsLambda);
+            } else {
+                constexpr auto sorted = lookup::SortedKeys<TKey>(makeStringsLambda);
+                constexpr auto NumKeys = lookup::CountDistinctKeys(sorted);
+
+                // the number of keys from the smallest to the largest, or 0 if that is too sparse
+                constexpr auto NumSlots = [=]() -> std::size_t {
+                    if(NumKeys == 0) {
+                        return 0;
+                    }
+
+                    // compared before adding one, so a range of every 64 bit key can't overflow
+                    auto const span = lookup::KeyBits(sorted.back().Key) - lookup::KeyBits(sorted.front().Key);
+                    auto const maxSpan = NumKeys * 100 / MIN_DENSITY_PERCENT;
+                    return span < maxSpan ? static_cast<std::size_t>(span) + 1 : 0;
+                }();
+
+                if constexpr (NumSlots == 0) {
+                    return SortedLookup::Compile<TKey, TEncoder>(makeStringsLambda);
+                } else {
+                    // one more value than the largest index, for the Empty sentinel
+                    using IndexType = lib::smallest_uint_t<sorted.size()>;
+                    constexpr auto MinKeyBits = lookup::KeyBits(sorted.front().Key);
+
+                    Data<TKey, MinKeyBits, NumSlots, IndexType> result{};
+                    result.m_Indices.fill(decltype(result)::Empty);
+
+                    // the first entry for each key comes first in sorted
+                    for(auto const &e : sorted) {
+                        auto &slot = result.m_Indices.at(lookup::KeyBits(e.Key) - MinKeyBits);
+                        if(slot == decltype(result)::Empty) {
+                            slot = static_cast<IndexType>(e.Index);
+                        }
+                    }
+
+                    return result;
+                }
+            }
+        }
+    };
+
+    // Direct indexing when at least half of the keys in the range are present
+    using DenseLookup = BasicDenseLookup<>;
+
+}
+
+#endif //SQUEEZE_LOOKUP_H
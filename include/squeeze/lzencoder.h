@@ -0,0 +1,604 @@
+#ifndef SQUEEZE_LZENCODER_H
+#define SQUEEZE_LZENCODER_H
+
+#include <string_view>
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <span>
+
+#include "concepts.h"
+#include "huffmanencoder.h"
+#include "lib/bit_stream.h"
+#include "lib/bit_reader.h"
+#include "lib/decode_iterator.h"
+#include "lib/smallest_uint.h"
+
+namespace squeeze
+{
+    namespace lz {
+
+        // Compile time options controlling how an LzEncoder builds its encoding
+        struct Options
+        {
+            // How many literals back a match may copy from. Literals from every string in the table
+            // are in the window, so repeats across strings are found. A larger window finds more
+            // matches, but costs more bits per match and more time to compile.
+            std::size_t WindowSize{1024};
+
+            // The shortest and longest runs of characters stored as a match rather than literals
+            std::size_t MinMatch{3};
+            std::size_t MaxMatch{64};
+
+            // When non-zero, literals are stored with canonical Huffman codes limited to this many bits,
+            // rather than a byte each.
+            std::size_t LiteralCodeLength{0};
+        };
+
+        // the most earlier positions with the same hash checked when looking for a match
+        constexpr std::size_t MaxChainLength = 64;
+        constexpr std::size_t HashBits = 12;
+
+        // A step of the parse: either the next literal, or a copy of Length literals starting at Source
+        struct Token
+        {
+            bool IsMatch{false};
+            std::size_t Source{0};
+            std::size_t Length{0};
+        };
+
+        // The tokens of every string and the literals they use, before they are encoded
+        template<std::size_t TOTAL_LENGTH, std::size_t NUM_STRINGS>
+        struct Parse
+        {
+            std::array<Token, TOTAL_LENGTH> Tokens{};
+            std::array<char, TOTAL_LENGTH> Literals{};
+            std::array<std::size_t, NUM_STRINGS + 1> FirstToken{};      // with the total at the end
+            std::array<std::size_t, NUM_STRINGS + 1> FirstLiteral{};
+        };
+
+        // How the tokens and literals of a table are stored. The tokens of a string are the length of a run of
+        // literals, followed by the match after the run, repeated until the string is complete.
+        struct Format
+        {
+            std::size_t RunBits{0};
+            std::size_t DistanceBits{0};
+            std::size_t DistanceUnit{0};    // bits of the literal stream per unit of distance
+            std::size_t LengthBits{0};
+            std::size_t MinMatch{0};
+            bool RawLiterals{true};         // literals are bytes, otherwise Huffman codes
+        };
+
+        // The number of run lengths written for a run of literals, each runBits long. The largest run length
+        // says another run length follows rather than a match, so long runs don't widen every run length.
+        // The last run of a string is followed by nothing, so it needs no run length to end it.
+        constexpr std::size_t RunLengths(std::size_t run, bool last, std::size_t runBits)
+        {
+            auto const largest = (std::size_t{1} << runBits) - 1;
+            return (last && run % largest == 0) ? run / largest : run / largest + 1;
+        }
+
+        // Where a string starts in the token and literal streams, and its original length
+        struct Entry
+        {
+            std::size_t TokenBit;
+            std::size_t LiteralBit;
+            std::size_t OriginalStringLength;
+        };
+
+        // The Entry for each compressed string, each field in the narrowest unsigned type for its largest value
+        template<std::size_t NUM_ENTRIES, std::size_t MAX_TOKEN_BIT, std::size_t MAX_LITERAL_BIT, std::size_t MAX_STRING_LENGTH>
+        class EntryIndex
+        {
+        public:
+            constexpr Entry operator[](std::size_t idx) const
+            {
+                return Entry{ m_TokenBits[idx], m_LiteralBits[idx], m_Lengths[idx] };
+            }
+
+            constexpr void set(std::size_t idx, Entry const &entry)
+            {
+                m_TokenBits.at(idx) = static_cast<lib::smallest_uint_t<MAX_TOKEN_BIT>>(entry.TokenBit);
+                m_LiteralBits.at(idx) = static_cast<lib::smallest_uint_t<MAX_LITERAL_BIT>>(entry.LiteralBit);
+                m_Lengths.at(idx) = static_cast<lib::smallest_uint_t<MAX_STRING_LENGTH>>(entry.OriginalStringLength);
+            }
+
+        private:
+            std::array<lib::smallest_uint_t<MAX_TOKEN_BIT>, NUM_ENTRIES> m_TokenBits;
+            std::array<lib::smallest_uint_t<MAX_LITERAL_BIT>, NUM_ENTRIES> m_LiteralBits;
+            std::array<lib::smallest_uint_t<MAX_STRING_LENGTH>, NUM_ENTRIES> m_Lengths;
+        };
+
+        // Reads literals, tracking the position in the literal stream so a match can find its source
+        class LiteralReader
+        {
+        public:
+            constexpr LiteralReader() = default;
+            constexpr LiteralReader(std::span<std::uint8_t const> stream, std::size_t bit) : m_Reader{stream, bit}, m_Bit{bit} {}
+
+            [[nodiscard]] constexpr std::uint64_t peek(std::size_t count) { return m_Reader.peek(count); }
+            constexpr void consume(std::size_t count) { m_Reader.consume(count); m_Bit += count; }
+
+            [[nodiscard]] constexpr std::size_t bit() const { return m_Bit; }
+
+        private:
+            lib::bit_reader m_Reader{};
+            std::size_t m_Bit{0};
+        };
+
+        // The decode tables when literals are stored as bytes
+        struct RawTables
+        {
+            [[nodiscard]] constexpr huffman::CodeBook code_book() const { return {}; }
+        };
+
+
+        // Represents a string that is being accessed, decoded a character at a time as it is iterated.
+        // No buffer is needed, as matches copy from the literal stream rather than the decoded output.
+        class IterableString
+        {
+        private:
+            // the decode position in the token and literal streams, and in the run or match being copied
+            struct Cursor
+            {
+                lib::bit_reader Tokens{};
+                LiteralReader Literals{};
+                LiteralReader Copy{};
+                std::size_t LiteralsLeft{0};
+                std::size_t CopyLeft{0};
+                bool MatchNext{false};
+            };
+
+        public:
+            using Iterator = lib::decode_iterator<IterableString>;
+            friend Iterator;
+
+            constexpr IterableString(
+                    Entry entry,
+                    Format format,
+                    std::span<std::uint8_t const> tokens,
+                    std::span<std::uint8_t const> literals,
+                    huffman::CodeBook codeBook
+            )
+                : m_Entry{entry}
+                , m_Format{format}
+                , m_Tokens{tokens}
+                , m_Literals{literals}
+                , m_CodeBook{codeBook}
+            {}
+
+            [[nodiscard]] constexpr std::size_t size() const { return m_Entry.OriginalStringLength; }
+
+            [[nodiscard]] constexpr Iterator begin() const { return Iterator{*this}; }
+            [[nodiscard]] constexpr Iterator end() const { return Iterator{typename Iterator::EndPosition{*this}}; }
+
+            // Decode the string into dest, stopping early if dest is too small.
+            // Returns the number of characters written.
+            constexpr std::size_t decode_into(std::span<char> dest) const
+            {
+                return decode_n(dest.begin(), std::min(dest.size(), size()));
+            }
+
+            // Decode the whole string to the output iterator. Returns the number of characters written.
+            template<typename TOutputIt>
+            constexpr std::size_t copy_to(TOutputIt out) const
+            {
+                return decode_n(out, size());
+            }
+
+        private:
+            [[nodiscard]] constexpr Cursor start() const
+            {
+                return Cursor{
+                    lib::bit_reader{m_Tokens, m_Entry.TokenBit},
+                    LiteralReader{m_Literals, m_Entry.LiteralBit},
+                    {},
+                    0,
+                    0,
+                    false };
+            }
+
+            // decode the next character, from the run or match being copied, reading the next token when
+            // both are done. A run may be empty, but a match never is.
+            constexpr char next(Cursor &cursor) const
+            {
+                while(cursor.LiteralsLeft == 0 && cursor.CopyLeft == 0) {
+                    if(cursor.MatchNext) {
+                        // a match copies literals that end before the next literal of this string
+                        auto const distance = cursor.Tokens.read(m_Format.DistanceBits);
+                        cursor.CopyLeft = cursor.Tokens.read(m_Format.LengthBits) + m_Format.MinMatch;
+                        cursor.Copy = LiteralReader{m_Literals, cursor.Literals.bit() - distance * m_Format.DistanceUnit};
+                        cursor.MatchNext = false;
+                    } else {
+                        cursor.LiteralsLeft = cursor.Tokens.read(m_Format.RunBits);
+                        cursor.MatchNext = cursor.LiteralsLeft != (std::size_t{1} << m_Format.RunBits) - 1;
+                    }
+                }
+
+                if(cursor.LiteralsLeft != 0) {
+                    --cursor.LiteralsLeft;
+                    return literal(cursor.Literals);
+                }
+
+                --cursor.CopyLeft;
+                return literal(cursor.Copy);
+            }
+
+            constexpr char literal(LiteralReader &reader) const
+            {
+                if(m_Format.RawLiterals) {
+                    auto const c = static_cast<char>(reader.peek(CHAR_BIT));
+                    reader.consume(CHAR_BIT);
+                    return c;
+                }
+
+                return m_CodeBook.decode(reader);
+            }
+
+            template<typename TOutputIt>
+            constexpr std::size_t decode_n(TOutputIt out, std::size_t count) const
+            {
+                auto cursor = start();
+                for(std::size_t i{0}; i < count; ++i) {
+                    *out++ = next(cursor);
+                }
+                return count;
+            }
+
+            Entry m_Entry;
+            Format m_Format;
+            std::span<std::uint8_t const> m_Tokens;
+            std::span<std::uint8_t const> m_Literals;
+            huffman::CodeBook m_CodeBook;
+        };
+
+
+        template<typename TEntryIndex, std::size_t NUM_ENTRIES, Format FORMAT, std::size_t NUM_TOKEN_BITS, std::size_t NUM_LITERAL_BITS, typename TTables>
+        struct Encoding
+        {
+            static constexpr std::size_t NumEntries = NUM_ENTRIES;
+
+            using StringType = IterableString;
+
+            constexpr StringType operator[](std::size_t idx) const
+            {
+                // bounds check without exceptions
+                if(idx >= NumEntries)
+                    return bad_string();
+
+                return make_string(m_Entries[idx]);
+            }
+
+            // provide a value that is an implementation defined value representing a
+            // bad key or index was requested.
+            constexpr StringType bad_string() const {
+                // this is an empty string
+                return make_string(Entry{0, 0, 0});
+            }
+
+            TEntryIndex m_Entries;
+            lib::bit_stream<NUM_TOKEN_BITS> m_Tokens;
+            lib::bit_stream<NUM_LITERAL_BITS> m_Literals;
+            [[no_unique_address]] TTables m_Tables;
+
+        private:
+            constexpr StringType make_string(Entry const &entry) const
+            {
+                return StringType{entry, FORMAT, m_Tokens.data(), m_Literals.data(), m_Tables.code_book()};
+            }
+        };
+
+
+        //
+        // Split the strings into literals and matches. Each match copies a run of earlier literals, from any
+        // string, no more than WindowSize literals back. Matches only copy literals, never other matches, so
+        // a match can be decoded straight from the literal stream.
+        //
+        // Earlier literals are found through chains of positions with the same hash of their first MinMatch
+        // characters. The longest match is taken, the nearest if there is more than one, but only when its
+        // matchBits cost less than the literalLength of the characters it covers.
+        //
+        template<Options OPTIONS, std::size_t TOTAL_LENGTH, std::size_t NUM_STRINGS>
+        static constexpr auto ParseStrings(CallableGivesIterableStringViews auto makeStringsLambda, auto literalLength, std::size_t matchBits)
+        {
+            constexpr auto st = makeStringsLambda();
+            constexpr std::size_t NoPosition = std::numeric_limits<std::size_t>::max();
+
+            Parse<TOTAL_LENGTH, NUM_STRINGS> result{};
+
+            // the last literal position with each hash, and the previous position with the same hash
+            std::array<std::size_t, std::size_t{1} << HashBits> head{};
+            head.fill(NoPosition);
+            std::array<std::size_t, TOTAL_LENGTH> previous{};
+
+            auto const hash = [](auto const &chars, std::size_t pos) {
+                std::size_t h{0};
+                for(std::size_t k{0}; k < OPTIONS.MinMatch; ++k) {
+                    h = h * 31 + static_cast<unsigned char>(chars[pos + k]);
+                }
+                return h & ((std::size_t{1} << HashBits) - 1);
+            };
+
+            std::size_t numTokens{0};
+            std::size_t numLiterals{0};
+            std::size_t s{0};
+
+            for(std::string_view const str : st) {
+                result.FirstToken.at(s) = numTokens;
+                result.FirstLiteral.at(s) = numLiterals;
+
+                std::size_t i{0};
+                while(i < str.size()) {
+                    Token best{};
+
+                    if(str.size() - i >= OPTIONS.MinMatch && numLiterals >= OPTIONS.MinMatch) {
+                        auto candidate = head.at(hash(str, i));
+                        for(std::size_t chain{0}; candidate != NoPosition && chain < MaxChainLength; ++chain) {
+                            if(numLiterals - candidate > OPTIONS.WindowSize) {
+                                break;      // older positions are further away
+                            }
+
+                            auto const limit = std::min({OPTIONS.MaxMatch, str.size() - i, numLiterals - candidate});
+                            std::size_t length{0};
+                            while(length < limit && result.Literals.at(candidate + length) == str[i + length]) {
+                                ++length;
+                            }
+
+                            if(length >= OPTIONS.MinMatch && length > best.Length) {
+                                best = Token{true, candidate, length};
+                            }
+
+                            candidate = previous.at(candidate);
+                        }
+
+                        std::size_t coveredBits{0};
+                        for(std::size_t k{0}; k < best.Length; ++k) {
+                            coveredBits += literalLength(str[i + k]);
+                        }
+                        if(coveredBits <= matchBits) {
+                            best = Token{};
+                        }
+                    }
+
+                    if(best.IsMatch) {
+                        result.Tokens.at(numTokens++) = best;
+                        i += best.Length;
+                        continue;
+                    }
+
+                    // a literal. Once it completes a run of MinMatch literals, the run can be matched
+                    result.Tokens.at(numTokens++) = Token{};
+                    result.Literals.at(numLiterals++) = str[i++];
+
+                    if(numLiterals >= OPTIONS.MinMatch) {
+                        auto const pos = numLiterals - OPTIONS.MinMatch;
+                        auto &h = head.at(hash(result.Literals, pos));
+                        previous.at(pos) = h;
+                        h = pos;
+                    }
+                }
+
+                ++s;
+            }
+
+            result.FirstToken.at(NUM_STRINGS) = numTokens;
+            result.FirstLiteral.at(NUM_STRINGS) = numLiterals;
+
+            return result;
+        }
+
+
+        template<Options OPTIONS = Options{}>
+        static constexpr auto MakeEncoding(CallableGivesIterableStringViews auto makeStringsLambda)
+        {
+            static_assert(OPTIONS.MinMatch >= 1 && OPTIONS.MaxMatch >= OPTIONS.MinMatch, "MaxMatch must be at least MinMatch, which must be at least 1");
+            static_assert(OPTIONS.WindowSize >= 1, "WindowSize must be at least 1");
+            static_assert(OPTIONS.LiteralCodeLength <= 32, "LiteralCodeLength must be 32 or less");
+
+            constexpr bool RawLiterals = OPTIONS.LiteralCodeLength == 0;
+
+            // get the string table to work with
+            constexpr auto st = makeStringsLambda();
+            constexpr auto NumStrings = static_cast<std::size_t>(std::distance(st.begin(), st.end()));
+            constexpr auto TotalLength = std::accumulate(
+                    st.begin(), st.end(), std::size_t{0},
+                    [](auto total, auto const &sv){ return total + sv.size(); });
+            constexpr auto MaxStringLength = std::accumulate(
+                    st.begin(), st.end(), std::size_t{0},
+                    [](std::size_t longest, auto const &sv){ return std::max(longest, sv.size()); });
+
+            // The code for each literal, and the tables to decode them. The Huffman code is built from every
+            // character of the strings, which covers every literal.
+            constexpr auto MakeCodes = [=]() {
+                if constexpr (RawLiterals) {
+                    return std::pair{ std::array<huffman::CharCode, 256>{}, RawTables{} };
+                } else {
+                    constexpr auto canonical = huffman::BuildCanonicalCode<OPTIONS.LiteralCodeLength>(makeStringsLambda);
+                    constexpr auto charLookup = huffman::MakeCanonicalCharacterCodes(canonical);
+                    return std::pair{
+                        charLookup,
+                        huffman::MakeCanonicalTables<0, OPTIONS.LiteralCodeLength>(canonical, charLookup) };
+                }
+            };
+
+            constexpr auto codes = MakeCodes();
+            constexpr auto charLookup = codes.first;
+
+            constexpr auto LiteralLength = [=](char c) -> std::size_t {
+                return RawLiterals ? CHAR_BIT : charLookup.at(static_cast<unsigned char>(c)).BitLength;
+            };
+
+            constexpr auto DistanceUnit = RawLiterals ? std::size_t{CHAR_BIT} : std::size_t{1};
+
+            // the bit position of each literal in the literal stream of a parse, with the total at the end
+            constexpr auto LiteralBitsOf = [=](auto const &parsed) {
+                std::array<std::size_t, TotalLength + 1> bits{};
+                for(std::size_t i{0}; i < parsed.FirstLiteral.at(NumStrings); ++i) {
+                    bits.at(i + 1) = bits.at(i) + LiteralLength(parsed.Literals.at(i));
+                }
+                return bits;
+            };
+
+            // the bits taken by the run lengths of a parse, when each is runBits long
+            constexpr auto RunLengthBitsOf = [=](auto const &parsed, std::size_t runBits) {
+                std::size_t bits{0};
+                for(std::size_t s{0}; s < NumStrings; ++s) {
+                    std::size_t run{0};
+                    for(std::size_t t{parsed.FirstToken.at(s)}; t < parsed.FirstToken.at(s + 1); ++t) {
+                        if(parsed.Tokens.at(t).IsMatch) {
+                            bits += RunLengths(run, false, runBits) * runBits;
+                            run = 0;
+                        } else {
+                            ++run;
+                        }
+                    }
+                    bits += RunLengths(run, true, runBits) * runBits;
+                }
+                return bits;
+            };
+
+            // the number of bits needed for the largest distance and length of any match, and the run length
+            // size that takes the fewest bits
+            constexpr auto FormatOf = [=](auto const &parsed) {
+                auto const bits = LiteralBitsOf(parsed);
+
+                std::size_t maxRun{0};
+                std::size_t maxDistance{0};
+                std::size_t maxLength{0};
+
+                for(std::size_t s{0}; s < NumStrings; ++s) {
+                    auto literal = parsed.FirstLiteral.at(s);
+                    std::size_t run{0};
+                    for(std::size_t t{parsed.FirstToken.at(s)}; t < parsed.FirstToken.at(s + 1); ++t) {
+                        auto const &token = parsed.Tokens.at(t);
+                        if(token.IsMatch) {
+                            auto const distance = (bits.at(literal) - bits.at(token.Source)) / DistanceUnit;
+                            maxDistance = std::max(maxDistance, distance);
+                            maxLength = std::max(maxLength, token.Length - OPTIONS.MinMatch);
+                            run = 0;
+                        } else {
+                            ++literal;
+                            maxRun = std::max(maxRun, ++run);
+                        }
+                    }
+                }
+
+                std::size_t runBits{1};
+                for(std::size_t b{2}; b <= lib::bits_needed(maxRun); ++b) {
+                    if(RunLengthBitsOf(parsed, b) < RunLengthBitsOf(parsed, runBits)) {
+                        runBits = b;
+                    }
+                }
+
+                return Format{runBits, lib::bits_needed(maxDistance), DistanceUnit, lib::bits_needed(maxLength), OPTIONS.MinMatch, RawLiterals};
+            };
+
+            // What a match costs depends on the largest distance and length, and the run length size, which are
+            // only known once the strings are parsed. The strings are parsed taking every match first, then
+            // twice more taking only the matches that cost less than their literals in the format of the parse
+            // before. Taking fewer matches makes runs longer, so the second costing is closer to the final one.
+            constexpr auto MatchBitsOf = [](Format const &f) { return f.RunBits + f.DistanceBits + f.LengthBits; };
+            constexpr auto firstFormat = FormatOf(ParseStrings<OPTIONS, TotalLength, NumStrings>(makeStringsLambda, LiteralLength, 0));
+            constexpr auto secondFormat = FormatOf(ParseStrings<OPTIONS, TotalLength, NumStrings>(makeStringsLambda, LiteralLength, MatchBitsOf(firstFormat)));
+            constexpr auto parse = ParseStrings<OPTIONS, TotalLength, NumStrings>(makeStringsLambda, LiteralLength, MatchBitsOf(secondFormat));
+
+            constexpr auto literalBits = LiteralBitsOf(parse);
+            constexpr auto format = FormatOf(parse);
+
+            // each match follows the run lengths of the literals before it
+            constexpr auto MatchLength = format.DistanceBits + format.LengthBits;
+
+            constexpr auto totalTokenBits = [=]() {
+                auto const numMatches = std::count_if(parse.Tokens.begin(), parse.Tokens.begin() + static_cast<std::ptrdiff_t>(parse.FirstToken.at(NumStrings)),
+                        [](Token const &token) { return token.IsMatch; });
+                return RunLengthBitsOf(parse, format.RunBits) + static_cast<std::size_t>(numMatches) * MatchLength;
+            }();
+
+            constexpr auto totalLiteralBits = literalBits.at(parse.FirstLiteral.at(NumStrings));
+
+            using EntryIndexType = EntryIndex<NumStrings, totalTokenBits, totalLiteralBits, MaxStringLength>;
+            Encoding<EntryIndexType, NumStrings, format, totalTokenBits, totalLiteralBits, std::remove_cvref_t<decltype(codes.second)>> result;
+
+            // write the literals
+            for(std::size_t i{0}; i < parse.FirstLiteral.at(NumStrings); ++i) {
+                auto const c = parse.Literals.at(i);
+                if constexpr (RawLiterals) {
+                    result.m_Literals.write(literalBits.at(i), static_cast<unsigned char>(c), CHAR_BIT);
+                } else {
+                    auto const &cd = charLookup.at(static_cast<unsigned char>(c));
+                    for(std::size_t done{0}; done < cd.BitLength; done += lib::bit_stream<totalLiteralBits>::MaxBulkBits) {
+                        auto const count = std::min(cd.BitLength - done, lib::bit_stream<totalLiteralBits>::MaxBulkBits);
+                        result.m_Literals.write(literalBits.at(i) + done, cd.Bits.peek(done, count), count);
+                    }
+                }
+            }
+
+            // write the tokens of each string
+            std::size_t bit{0};
+            std::size_t s{0};
+            for(auto const &sv : st) {
+                auto literal = parse.FirstLiteral.at(s);
+                result.m_Entries.set(s, Entry{bit, literalBits.at(literal), sv.size()});
+
+                // write the run lengths of a run of literals, the largest for each full part of the run
+                auto const writeRun = [&](std::size_t run, bool last) {
+                    auto const largest = (std::size_t{1} << format.RunBits) - 1;
+                    for(std::size_t n{RunLengths(run, last, format.RunBits)}; n > 0; --n) {
+                        auto const length = std::min(run, largest);
+                        result.m_Tokens.write(bit, n > 1 ? largest : length, format.RunBits);
+                        bit += format.RunBits;
+                        run -= length;
+                    }
+                };
+
+                std::size_t run{0};
+                for(std::size_t t{parse.FirstToken.at(s)}; t < parse.FirstToken.at(s + 1); ++t) {
+                    auto const &token = parse.Tokens.at(t);
+                    if(token.IsMatch) {
+                        auto const distance = (literalBits.at(literal) - literalBits.at(token.Source)) / DistanceUnit;
+                        writeRun(run, false);
+                        result.m_Tokens.write(bit, distance, format.DistanceBits);
+                        result.m_Tokens.write(bit + format.DistanceBits, token.Length - OPTIONS.MinMatch, format.LengthBits);
+                        bit += MatchLength;
+                        run = 0;
+                    } else {
+                        ++literal;
+                        ++run;
+                    }
+                }
+                writeRun(run, true);
+
+                ++s;
+            }
+
+            result.m_Tables = codes.second;
+
+            return result;
+        }
+    }
+
+    template<lz::Options OPTIONS = lz::Options{}>
+    class BasicLzEncoder
+    {
+    public:
+
+        static constexpr auto Compile(CallableGivesIterableStringViews auto makeStringsLambda)
+        {
+            constexpr auto const encoding = lz::MakeEncoding<OPTIONS>(makeStringsLambda);
+
+            return encoding;
+        }
+    };
+
+    // LZ77 style encoding, with repeated runs of characters stored as matches and the literals stored as bytes
+    using LzEncoder = BasicLzEncoder<>;
+
+    // LZ77 style encoding, with the literals stored as canonical Huffman codes limited to 12 bits
+    using HuffmanLzEncoder = BasicLzEncoder<lz::Options{.LiteralCodeLength = 12}>;
+
+}
+
+#endif //SQUEEZE_LZENCODER_H
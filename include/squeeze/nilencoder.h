@@ -3,8 +3,11 @@
 
 #include <string_view>
 #include <array>
+#include <numeric>
 
 #include "concepts.h"
+#include "lib/smallest_uint.h"
+#include "lib/suffix_owners.h"
 
 namespace squeeze
 {
@@ -16,6 +19,9 @@ namespace squeeze
         {
             static constexpr std::size_t NumEntries = NUM_ENTRIES;
 
+            // string start offsets use the narrowest type that can index the whole store
+            using OffsetType = lib::smallest_uint_t<STORE_LENGTH>;
+
             constexpr std::string_view operator[](std::size_t idx) const
             {
                 // bounds check without exceptions
@@ -24,8 +30,8 @@ namespace squeeze
 
                 // find the start of the next string to get its start. This might be the last entry
                 // in which case the nextStart is the end of the storage
-                auto const nextStart = (idx < NUM_ENTRIES-1) ? m_Entries.at(idx + 1) : STORE_LENGTH;
-                auto const thisStart = m_Entries[idx];
+                std::size_t const nextStart = (idx < NUM_ENTRIES-1) ? m_Entries.at(idx + 1) : STORE_LENGTH;
+                std::size_t const thisStart = m_Entries[idx];
 
                 return std::string_view{&m_Storage[thisStart], nextStart - thisStart};
             }
@@ -37,10 +43,43 @@ namespace squeeze
                 return std::string_view{};
             }
 
-            std::array<std::size_t, NUM_ENTRIES> m_Entries;
+            std::array<OffsetType, NUM_ENTRIES> m_Entries;
             std::array<char, STORE_LENGTH> m_Storage;
         };
 
+        // The strings with identical strings and suffixes of other strings sharing their storage. Each
+        // string's length is stored, as its start no longer gives the end of the string before it.
+        template<std::size_t STORE_LENGTH, std::size_t NUM_ENTRIES, std::size_t MAX_STRING_LENGTH>
+        struct SharedTableData
+        {
+            static constexpr std::size_t NumEntries = NUM_ENTRIES;
+
+            using OffsetType = lib::smallest_uint_t<STORE_LENGTH>;
+            using LengthType = lib::smallest_uint_t<MAX_STRING_LENGTH>;
+
+            constexpr std::string_view operator[](std::size_t idx) const
+            {
+                // bounds check without exceptions
+                if(idx >= NumEntries)
+                    return bad_string();
+
+                return std::string_view{m_Storage.data() + m_Offsets[idx], m_Lengths[idx]};
+            }
+
+            // provide a value that is an implementation defined value representing a
+            // bad key or index was requested.
+            constexpr std::string_view bad_string() const
+            {
+                return std::string_view{};
+            }
+
+            std::array<OffsetType, NUM_ENTRIES> m_Offsets;
+            std::array<LengthType, NUM_ENTRIES> m_Lengths;
+            std::array<char, STORE_LENGTH> m_Storage;
+        };
+
+        // Stores the strings end to end, unless sharing the storage of duplicate strings and suffixes
+        // saves more than storing the length of every string costs.
         static constexpr auto Compile(CallableGivesIterableStringViews auto makeStringsLambda)
         {
             // get the string table to work with
@@ -51,20 +90,65 @@ namespace squeeze
             constexpr auto TotalStringLength = std::accumulate(
                     st.begin(), st.end(), std::size_t{0},
                     [](auto total, auto const &sv){ return total + sv.size(); });
+            constexpr auto MaxStringLength = std::accumulate(
+                    st.begin(), st.end(), std::size_t{0},
+                    [](std::size_t longest, auto const &sv){ return std::max(longest, sv.size()); });
+
+            // the strings that are stored, the rest are read from the end of their owner
+            constexpr auto owners = lib::suffix_owners<NumStrings>(st);
+            constexpr auto SharedStringLength = [=]() {
+                std::size_t total{0};
+                std::size_t idx{0};
+                for(auto const &sv : st) {
+                    if(owners.at(idx) == idx) {
+                        total += sv.size();
+                    }
+                    ++idx;
+                }
+                return total;
+            }();
+
+            using PackedType = TableData<TotalStringLength, NumStrings>;
+            using SharedType = SharedTableData<SharedStringLength, NumStrings, MaxStringLength>;
+
+            if constexpr (sizeof(SharedType) < sizeof(PackedType)) {
+                SharedType result{};
+
+                // copy the owners into the result in order, then point the others into them
+                std::size_t loc{0};
+                std::size_t idx{0};
+                for(auto const &sv : st) {
+                    if(owners.at(idx) == idx) {
+                        result.m_Offsets.at(idx) = static_cast<typename SharedType::OffsetType>(loc);
+                        loc = static_cast<std::size_t>(std::distance(result.m_Storage.begin(),
+                            std::copy(sv.begin(), sv.end(), result.m_Storage.begin() + static_cast<std::ptrdiff_t>(loc))));
+                    }
+                    result.m_Lengths.at(idx) = static_cast<typename SharedType::LengthType>(sv.size());
+                    ++idx;
+                }
+
+                for(std::size_t i{0}; i < result.m_Offsets.size(); ++i) {
+                    auto const owner = owners.at(i);
+                    result.m_Offsets.at(i) = static_cast<typename SharedType::OffsetType>(
+                        result.m_Offsets.at(owner) + result.m_Lengths.at(owner) - result.m_Lengths.at(i));
+                }
 
-            TableData<TotalStringLength, NumStrings> result;
+                return result;
+            } else {
+                PackedType result;
 
-            // copy the strings into the result, and build the list of string start locations
-            auto loc = result.m_Storage.begin();
-            std::size_t idx = 0;
-            for (auto &sv : st) {
-                auto const end = std::copy(sv.begin(), sv.end(), loc);
-                result.m_Entries.at(idx) = static_cast<std::size_t>(std::distance(result.m_Storage.begin(), loc));
+                // copy the strings into the result, and build the list of string start locations
+                auto loc = result.m_Storage.begin();
+                std::size_t idx = 0;
+                for (auto &sv : st) {
+                    auto const end = std::copy(sv.begin(), sv.end(), loc);
+                    result.m_Entries.at(idx) = static_cast<typename PackedType::OffsetType>(std::distance(result.m_Storage.begin(), loc));
 
-                ++idx;
-                loc = end;
+                    ++idx;
+                    loc = end;
+                }
+                return result;
             }
-            return result;
         }
     };
 }
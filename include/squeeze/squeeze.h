@@ -2,16 +2,55 @@
 #define SQUEEZE_SQUEEZE_H
 
 #include <string_view>
+#include <algorithm>
 #include <array>
 #include <numeric>
+#include <optional>
+#include <span>
+#include <utility>
 
 #include "concepts.h"
 #include "nilencoder.h"
 #include "huffmanencoder.h"
+#include "lzencoder.h"
+#include "tokenencoder.h"
+#include "fsstencoder.h"
+#include "tansencoder.h"
+#include "contexthuffmanencoder.h"
+#include "hybridencoder.h"
+#include "autoencoder.h"
+#include "lookup.h"
 
 namespace squeeze
 {
     namespace impl {
+        // Copy a whole string returned by an encoder to the output iterator, using the string's
+        // bulk decoder if it has one. Returns the number of characters written.
+        template<typename TString, typename TOutputIt>
+        constexpr std::size_t CopyString(TString const &str, TOutputIt out)
+        {
+            if constexpr (requires { str.copy_to(out); }) {
+                return str.copy_to(out);
+            } else {
+                std::copy(str.begin(), str.end(), out);
+                return str.size();
+            }
+        }
+
+        // Copy a string returned by an encoder into dest, stopping early if dest is too small.
+        // Returns the number of characters written.
+        template<typename TString>
+        constexpr std::size_t DecodeString(TString const &str, std::span<char> dest)
+        {
+            if constexpr (requires { str.decode_into(dest); }) {
+                return str.decode_into(dest);
+            } else {
+                auto const count = std::min(dest.size(), str.size());
+                std::copy_n(str.begin(), count, dest.begin());
+                return count;
+            }
+        }
+
         template<typename TData>
         class StringTableDataImpl {
         public:
@@ -26,57 +65,88 @@ namespace squeeze
                 return m_Data[idx];
             }
 
+            // Decode the string at the given index into dest, stopping early if dest is too small.
+            // Returns the number of characters written, 0 for an index outside the table.
+            constexpr std::size_t decode_into(std::size_t idx, std::span<char> dest) const {
+                return DecodeString(m_Data[idx], dest);
+            }
+
+            // Decode the whole string at the given index to the output iterator.
+            // Returns the number of characters written, 0 for an index outside the table.
+            template<typename TOutputIt>
+            constexpr std::size_t copy_to(std::size_t idx, TOutputIt out) const {
+                return CopyString(m_Data[idx], out);
+            }
+
         private:
             TData m_Data;
         };
 
 
-        template<typename TKey>
-        struct KeyMap
-        {
-            TKey Key;
-            std::size_t Index;
-        };
-
-        template<typename TKey, typename TData>
+        template<typename TKey, typename TData, typename TLookupData>
         class StringMapDataImpl {
         public:
             constexpr static std::size_t NumEntries = TData::NumEntries;
 
             using KeyType = TKey;
-            using KeyMapType = KeyMap<TKey>;
-            using LookupType = std::array<KeyMapType, NumEntries>;
+            using LookupType = TLookupData;
+            using StringType = decltype(std::declval<TData const &>().bad_string());
 
             constexpr StringMapDataImpl(LookupType lookup, TData data) : m_Lookup{lookup}, m_Data{data} {}
 
             // the number of strings
             constexpr std::size_t count() const { return TData::NumEntries; }
 
+            // Find the given key, giving a handle that can be tested, and passed to get() to fetch the string
+            // without searching again.
+            constexpr lookup::Handle find(KeyType key) const {
+                return lookup::Handle{m_Lookup.find(key)};
+            }
+
             // Get the string for the given key. Note that if the string is not present in the
             // map, an empty result will be returned. Use contains() to determine if the string exists.
             constexpr auto get(KeyType key) const {
-                // finds the first entry that is no less than the key. May be end(), or higher than the key
-                auto entry = std::lower_bound(
-                        m_Lookup.begin(), m_Lookup.end(), key,
-                        [](auto const &e, auto const& v){return e.Key < v;}
-                );
+                return get(find(key));
+            }
 
-                if(entry == m_Lookup.end() || (*entry).Key != key) {  // could be larger key value
+            // Get the string for a key found with find(). If the key was not found, an empty result will be returned.
+            constexpr auto get(lookup::Handle handle) const {
+                if(!handle) {
                     // use the bad_string() result. this is an "empty" string however that is
                     // represented by the encoded data.
                     return m_Data.bad_string();
                 }
 
-                return m_Data[(*entry).Index];
+                return m_Data[handle.Index];
+            }
+
+            // Get the string for the given key, or nothing if the map does not contain the key.
+            constexpr std::optional<StringType> try_get(KeyType key) const {
+                auto const handle = find(key);
+                if(!handle) {
+                    return std::nullopt;
+                }
+
+                return get(handle);
+            }
+
+            // Decode the string for the given key into dest, stopping early if dest is too small.
+            // Returns the number of characters written, 0 if the key is not in the map.
+            constexpr std::size_t decode_into(KeyType key, std::span<char> dest) const {
+                return DecodeString(get(key), dest);
+            }
+
+            // Decode the whole string for the given key to the output iterator.
+            // Returns the number of characters written, 0 if the key is not in the map.
+            template<typename TOutputIt>
+            constexpr std::size_t copy_to(KeyType key, TOutputIt out) const {
+                return CopyString(get(key), out);
             }
 
             // Determine if the map contains the given key. If this returns false,
             // a call to get() for that key will return an empty result.
             constexpr bool contains(KeyType key) const {
-                return m_Lookup.end() != std::find_if(
-                    m_Lookup.begin(),
-                    m_Lookup.end(),
-                    [=](auto const &e){return e.Key == key;});
+                return static_cast<bool>(find(key));
             }
 
         private:
@@ -108,28 +178,41 @@ namespace squeeze
             };
         }
 
-        template<typename TKey, typename TEncoder>
+        // The map's entries in the order the lookup policy needs its strings stored
+        template<typename TKey, typename TLookup>
+        static constexpr auto OrderForLookup(CallableGivesIterableKeyedStringViews<TKey> auto f) -> CallableGivesIterableKeyedStringViews<TKey> auto
+        {
+            if constexpr (lookup::SortsStrings<TLookup>) {
+                return lookup::SortByKey<TKey>(f);
+            } else {
+                return f;
+            }
+        }
+
+        template<typename TKey, typename TEncoder, typename TLookup>
         static constexpr auto CompileMap(CallableGivesIterableKeyedStringViews<TKey> auto f) {
-            constexpr auto map = f();
-            constexpr auto NumStrings = std::distance(map.begin(), map.end());
+            auto const ordered = OrderForLookup<TKey, TLookup>(f);
 
             // encode the string using the table encoder
-            constexpr auto data = TEncoder::Compile(MapToStrings<TKey>(f));
+            constexpr auto data = TEncoder::Compile(MapToStrings<TKey>(ordered));
 
             // build the lookup for key->index mapping
-            std::array<KeyMap<TKey>, NumStrings> lookup;
-
-            std::size_t idx{0};
-            for(auto const &v : map) {
-                lookup.at(idx).Key = v.Key;
-                lookup.at(idx).Index = idx;
-                ++idx;
-            }
-            // ensure it is sorted by key for searching
-            std::sort(lookup.begin(), lookup.end(), [](auto &a, auto &b) { return a.Key < b.Key;});
+            constexpr auto lookup = TLookup::template Compile<TKey, TEncoder>(ordered);
 
             // build the final result with the lookup and data
-            StringMapDataImpl<TKey, decltype(data)> result{lookup, data};
+            StringMapDataImpl<TKey, decltype(data), decltype(lookup)> result{lookup, data};
+            return result;
+        }
+
+        template<typename TKey, typename TEncoder>
+        static constexpr auto CompileRangeMap(CallableGivesIterableKeyedRangeStringViews<TKey> auto f) {
+            // the strings are stored in the order of the ranges, so no index is needed for each range
+            auto const ordered = RangeLookup::SortRanges<TKey>(f);
+
+            constexpr auto data = TEncoder::Compile(RangeLookup::RangesToStrings<TKey>(ordered));
+            constexpr auto lookup = RangeLookup::Compile<TKey>(ordered);
+
+            StringMapDataImpl<TKey, decltype(data), decltype(lookup)> result{lookup, data};
             return result;
         }
     }
@@ -141,10 +224,17 @@ namespace squeeze
         return impl::CompileTable<TEncoder>(makeStringsLambda);
     }
 
-    template<typename TKey, typename TEncoder = HuffmanEncoder>
+    template<typename TKey, typename TEncoder = HuffmanEncoder, typename TLookup = DenseLookup>
     constexpr auto StringMap(CallableGivesIterableKeyedStringViews<TKey> auto makeStringsLambda)
     {
-        return impl::CompileMap<TKey, TEncoder>(makeStringsLambda);
+        return impl::CompileMap<TKey, TEncoder, TLookup>(makeStringsLambda);
+    }
+
+    // A map from ranges of keys to strings. Every key from Low to High inclusive gives the range's string.
+    template<typename TKey, typename TEncoder = HuffmanEncoder>
+    constexpr auto StringRangeMap(CallableGivesIterableKeyedRangeStringViews<TKey> auto makeRangesLambda)
+    {
+        return impl::CompileRangeMap<TKey, TEncoder>(makeRangesLambda);
     }
 
 }
@@ -0,0 +1,420 @@
+#ifndef SQUEEZE_TANSENCODER_H
+#define SQUEEZE_TANSENCODER_H
+
+#include <string_view>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <climits>
+#include <cstdint>
+#include <iterator>
+#include <numeric>
+#include <span>
+
+#include "concepts.h"
+#include "huffmanencoder.h"
+#include "lib/bit_reader.h"
+#include "lib/bit_stream.h"
+#include "lib/decode_iterator.h"
+#include "lib/smallest_uint.h"
+
+namespace squeeze
+{
+    namespace tans {
+
+        // Compile time options controlling how a TansEncoder builds its tables
+        struct Options
+        {
+            // The decode table has 2^TableLog states. Bigger tables follow the character frequencies
+            // more closely but take more space. 0 picks the size that gives the smallest footprint.
+            std::size_t TableLog{0};
+        };
+
+        // The smallest and largest table sizes, as powers of 2
+        constexpr std::size_t MinTableLog = 5;
+        constexpr std::size_t MaxTableLog = 15;
+
+        // The largest table size picked when TableLog is 0. Bigger tables rarely pay for themselves.
+        constexpr std::size_t MaxAutoTableLog = 12;
+
+        // What decoding each state gives: the character, and the next state once NumBits more
+        // bits have been read and added to NextState
+        struct DecodeEntry
+        {
+            char Symbol;
+            std::uint8_t NumBits;
+            std::uint16_t NextState;
+        };
+
+        // Decode from a state to the next, with a table lookup and no branches
+        struct Decoder
+        {
+            std::span<DecodeEntry const> Table;
+
+            constexpr char step(std::size_t &state, lib::bit_reader &reader) const
+            {
+                auto const &entry = Table[state];
+                state = entry.NextState + reader.read(entry.NumBits);
+                return entry.Symbol;
+            }
+        };
+
+
+        // Represents a string that is being accessed, decoding a character at a time as it is iterated.
+        class IterableString
+        {
+        private:
+            // the decoder state, and the reader for the bits that follow it
+            struct Cursor
+            {
+                lib::bit_reader Reader{};
+                std::size_t State{0};
+            };
+
+        public:
+            using Iterator = lib::decode_iterator<IterableString>;
+            friend Iterator;
+
+            constexpr IterableString(std::span<std::uint8_t const> stream, std::size_t firstBit, std::size_t stringLength, Decoder decoder)
+                : m_Stream{stream}
+                , m_FirstBit{firstBit}
+                , m_StringLength{stringLength}
+                , m_Decoder{decoder}
+            {}
+
+            [[nodiscard]] constexpr std::size_t size() const { return m_StringLength; }
+
+            [[nodiscard]] constexpr Iterator begin() const { return Iterator{*this}; }
+            [[nodiscard]] constexpr Iterator end() const { return Iterator{typename Iterator::EndPosition{*this}}; }
+
+            // Decode the string into dest, stopping early if dest is too small.
+            // Returns the number of characters written.
+            constexpr std::size_t decode_into(std::span<char> dest) const
+            {
+                return decode_n(dest.begin(), std::min(dest.size(), m_StringLength));
+            }
+
+            // Decode the whole string to the output iterator. Returns the number of characters written.
+            template<typename TOutputIt>
+            constexpr std::size_t copy_to(TOutputIt out) const
+            {
+                return decode_n(out, m_StringLength);
+            }
+
+        private:
+            // read the initial state, and position the reader after it. Empty strings store no state.
+            [[nodiscard]] constexpr Cursor start() const
+            {
+                Cursor result{lib::bit_reader{m_Stream, m_FirstBit}, 0};
+                result.State = result.Reader.read(static_cast<std::size_t>(std::countr_zero(m_Decoder.Table.size())));
+                return result;
+            }
+
+            constexpr char next(Cursor &cursor) const
+            {
+                return m_Decoder.step(cursor.State, cursor.Reader);
+            }
+
+            template<typename TOutputIt>
+            constexpr std::size_t decode_n(TOutputIt out, std::size_t count) const
+            {
+                if(count == 0) {
+                    return 0;
+                }
+
+                auto cursor = start();
+                for(std::size_t i{0}; i < count; ++i) {
+                    *out++ = next(cursor);
+                }
+                return count;
+            }
+
+            std::span<std::uint8_t const> m_Stream;
+            std::size_t m_FirstBit;
+            std::size_t m_StringLength;
+            Decoder m_Decoder;
+        };
+
+
+        template<typename TEntryIndex, std::size_t NUM_ENCODED_BITS, std::size_t TABLE_SIZE>
+        struct Encoding
+        {
+            static constexpr std::size_t NumEntries = TEntryIndex::NumEntries;
+
+            using StringType = IterableString;
+
+            constexpr StringType operator[](std::size_t idx) const
+            {
+                // bounds check without exceptions
+                if(idx >= NumEntries)
+                    return bad_string();
+
+                auto const entry = m_Entries[idx];
+                return StringType{m_CompressedStream.data(), entry.FirstBit, entry.OriginalStringLength, Decoder{m_Table}};
+            }
+
+            // provide a value that is an implementation defined value representing a
+            // bad key or index was requested.
+            constexpr StringType bad_string() const {
+                // this is an empty string
+                return StringType{{}, 0, 0, Decoder{m_Table}};
+            }
+
+            TEntryIndex m_Entries;
+            lib::bit_stream<NUM_ENCODED_BITS> m_CompressedStream;
+            std::array<DecodeEntry, TABLE_SIZE> m_Table;
+        };
+
+
+        // The normalised counts and the tables to encode and decode with, only the decode table is stored
+        template<std::size_t NUM_SYMBOLS, std::size_t TABLE_LOG>
+        struct Model
+        {
+            static constexpr std::size_t TableSize = std::size_t{1} << TABLE_LOG;
+
+            std::array<std::size_t, 256> SymbolOf{};                // the symbol for each character
+            std::array<std::size_t, NUM_SYMBOLS> Counts{};          // how many states each symbol has
+            std::array<std::size_t, NUM_SYMBOLS> FirstSlot{};       // where each symbol's states start in Slots
+            std::array<std::size_t, TableSize> Slots{};             // the states of each symbol, in order
+            std::array<DecodeEntry, TableSize> Decode{};
+
+            // The bits to write to encode the character from state, which is in [TableSize, 2 * TableSize).
+            // The state moves to the one that decodes to the character.
+            struct Bits
+            {
+                std::uint64_t Value;
+                std::size_t Count;
+            };
+
+            [[nodiscard]] constexpr Bits encode(std::size_t &state, char c) const
+            {
+                auto const s = SymbolOf.at(static_cast<unsigned char>(c));
+                auto const count = Counts.at(s);
+
+                std::size_t numBits{0};
+                while((state >> numBits) >= 2 * count) {
+                    ++numBits;
+                }
+
+                Bits const result{state & ((std::size_t{1} << numBits) - 1), numBits};
+                state = TableSize + Slots.at(FirstSlot.at(s) + (state >> numBits) - count);
+                return result;
+            }
+
+            // the state to start encoding from to end with the character, without writing any bits
+            [[nodiscard]] constexpr std::size_t initial_state(char c) const
+            {
+                return TableSize + Slots.at(FirstSlot.at(SymbolOf.at(static_cast<unsigned char>(c))));
+            }
+        };
+
+        //
+        // Normalise the character counts to the table size, keeping every character, and spread each
+        // character's states through the table. Each state of a character decodes to the next state
+        // for it, ready for the bits that were shifted out when it was encoded.
+        //
+        template<std::size_t TABLE_LOG, std::size_t NUM_SYMBOLS>
+        static constexpr auto BuildModel(std::array<huffman::CharFrequency, NUM_SYMBOLS> const &ft)
+        {
+            using ModelType = Model<NUM_SYMBOLS, TABLE_LOG>;
+            constexpr auto TableSize = ModelType::TableSize;
+
+            ModelType result{};
+
+            // strings with no characters have nothing to decode
+            if constexpr (NUM_SYMBOLS == 0) {
+                return result;
+            }
+
+            auto const total = std::accumulate(ft.begin(), ft.end(), std::size_t{0},
+                    [](auto sum, auto const &f){ return sum + f.frequency; });
+
+            std::size_t normalised{0};
+            for(std::size_t s{0}; s < NUM_SYMBOLS; ++s) {
+                result.SymbolOf.at(static_cast<unsigned char>(ft.at(s).c)) = s;
+                result.Counts.at(s) = std::max(std::size_t{1}, ft.at(s).frequency * TableSize / total);
+                normalised += result.Counts.at(s);
+            }
+
+            // rounding leaves the total off the table size, the most frequent symbols absorb the difference
+            while(normalised != TableSize) {
+                auto const largest = static_cast<std::size_t>(std::distance(result.Counts.begin(), std::max_element(result.Counts.begin(), result.Counts.end())));
+                if(normalised < TableSize) {
+                    result.Counts.at(largest) += TableSize - normalised;
+                    normalised = TableSize;
+                } else {
+                    --result.Counts.at(largest);
+                    --normalised;
+                }
+            }
+
+            // spread the symbols so each one's states are scattered through the table
+            constexpr std::size_t Step = (TableSize >> 1) + (TableSize >> 3) + 3;
+            std::array<std::size_t, TableSize> symbolAt{};
+            std::size_t position{0};
+            for(std::size_t s{0}; s < NUM_SYMBOLS; ++s) {
+                for(std::size_t i{0}; i < result.Counts.at(s); ++i) {
+                    symbolAt.at(position) = s;
+                    position = (position + Step) & (TableSize - 1);
+                }
+            }
+
+            std::exclusive_scan(result.Counts.begin(), result.Counts.end(), result.FirstSlot.begin(), std::size_t{0});
+
+            std::array<std::size_t, NUM_SYMBOLS> next{result.Counts};
+            for(std::size_t state{0}; state < TableSize; ++state) {
+                auto const s = symbolAt.at(state);
+                auto const x = next.at(s)++;
+                auto const numBits = TABLE_LOG + 1 - static_cast<std::size_t>(std::bit_width(x));
+
+                result.Slots.at(result.FirstSlot.at(s) + x - result.Counts.at(s)) = state;
+                result.Decode.at(state) = DecodeEntry{
+                    ft.at(s).c,
+                    static_cast<std::uint8_t>(numBits),
+                    static_cast<std::uint16_t>((x << numBits) - TableSize)
+                };
+            }
+
+            return result;
+        }
+
+
+        //
+        // Encode a string, calling emit with the bits in the order the decoder reads them. The string is
+        // encoded last character first, so the bits are gathered and emitted in reverse. The final state
+        // comes first, then the bits for each character from the first.
+        //
+        template<std::size_t MAX_STRING_LENGTH, typename TModel>
+        static constexpr void EncodeString(TModel const &model, std::string_view str, auto emit)
+        {
+            if(str.empty()) {
+                return;
+            }
+
+            std::array<typename TModel::Bits, MAX_STRING_LENGTH> bits{};
+            auto state = model.initial_state(str.back());
+            for(auto i = str.size() - 1; i-- > 0;) {
+                bits.at(i) = model.encode(state, str.at(i));
+            }
+
+            emit(state - TModel::TableSize, static_cast<std::size_t>(std::countr_zero(TModel::TableSize)));
+            for(std::size_t i{0}; i + 1 < str.size(); ++i) {
+                emit(bits.at(i).Value, bits.at(i).Count);
+            }
+        }
+
+
+        // The bytes taken by the encoded strings and the decode table, with 2^TABLE_LOG states
+        template<std::size_t TABLE_LOG>
+        static constexpr std::size_t Footprint(CallableGivesIterableStringViews auto makeStringsLambda)
+        {
+            constexpr auto st = makeStringsLambda();
+            constexpr auto MaxStringLength = std::accumulate(
+                    st.begin(), st.end(), std::size_t{0},
+                    [](std::size_t longest, auto const &sv){ return std::max(longest, sv.size()); });
+
+            constexpr auto ft = huffman::BuildFrequencyTable(makeStringsLambda);
+            constexpr auto model = BuildModel<TABLE_LOG>(ft);
+
+            std::size_t bits{0};
+            for(std::string_view const str : st) {
+                EncodeString<MaxStringLength>(model, str, [&](auto, std::size_t count) { bits += count; });
+            }
+
+            return (bits + CHAR_BIT - 1) / CHAR_BIT + sizeof(model.Decode);
+        }
+
+        //
+        // Pick the table size for the strings, starting from TABLE_LOG. The table grows while the bits it
+        // saves in the encoded strings are more than the bytes it adds to the decode table.
+        //
+        template<std::size_t TABLE_LOG>
+        static constexpr std::size_t ChooseTableLog(CallableGivesIterableStringViews auto makeStringsLambda)
+        {
+            if constexpr (TABLE_LOG >= MaxAutoTableLog) {
+                return TABLE_LOG;
+            } else {
+                if(Footprint<TABLE_LOG + 1>(makeStringsLambda) >= Footprint<TABLE_LOG>(makeStringsLambda)) {
+                    return TABLE_LOG;
+                }
+                return ChooseTableLog<TABLE_LOG + 1>(makeStringsLambda);
+            }
+        }
+
+
+        template<Options OPTIONS = Options{}>
+        static constexpr auto MakeEncoding(CallableGivesIterableStringViews auto makeStringsLambda)
+        {
+            // get the string table to work with
+            constexpr auto st = makeStringsLambda();
+            constexpr auto NumStrings = static_cast<std::size_t>(std::distance(st.begin(), st.end()));
+            constexpr auto MaxStringLength = std::accumulate(
+                    st.begin(), st.end(), std::size_t{0},
+                    [](std::size_t longest, auto const &sv){ return std::max(longest, sv.size()); });
+
+            // the same character counts the Huffman encoders use
+            constexpr auto ft = huffman::BuildFrequencyTable(makeStringsLambda);
+            constexpr auto Log = [=]() {
+                if constexpr (OPTIONS.TableLog != 0) {
+                    return OPTIONS.TableLog;
+                } else {
+                    // the smallest table with a state for every character
+                    constexpr auto SmallestLog = std::max(MinTableLog, lib::bits_needed(std::max(ft.size(), std::size_t{1}) - 1));
+                    return ChooseTableLog<SmallestLog>(makeStringsLambda);
+                }
+            }();
+
+            static_assert(Log >= MinTableLog && Log <= MaxTableLog, "TableLog must be from 5 to 15");
+            static_assert((std::size_t{1} << Log) >= ft.size(), "TableLog is too small for the number of characters used");
+
+            constexpr auto model = BuildModel<Log>(ft);
+            using ModelType = std::remove_cvref_t<decltype(model)>;
+
+            constexpr auto TotalEncodedBits = [=]() {
+                std::size_t bits{0};
+                for(std::string_view const str : st) {
+                    EncodeString<MaxStringLength>(model, str, [&](auto, std::size_t count) { bits += count; });
+                }
+                return bits;
+            }();
+
+            using EntryIndexType = huffman::EntryIndex<NumStrings, TotalEncodedBits, MaxStringLength>;
+            Encoding<EntryIndexType, TotalEncodedBits, ModelType::TableSize> result{};
+
+            std::size_t entry{0};
+            std::size_t bit{0};
+            for(std::string_view const str : st) {
+                result.m_Entries.set(entry++, huffman::Entry{bit, str.size()});
+                EncodeString<MaxStringLength>(model, str, [&](std::uint64_t value, std::size_t count) {
+                    result.m_CompressedStream.write(bit, value, count);
+                    bit += count;
+                });
+            }
+
+            result.m_Table = model.Decode;
+
+            return result;
+        }
+    }
+
+    template<tans::Options OPTIONS = tans::Options{}>
+    class BasicTansEncoder
+    {
+    public:
+
+        static constexpr auto Compile(CallableGivesIterableStringViews auto makeStringsLambda)
+        {
+            constexpr auto const encoding = tans::MakeEncoding<OPTIONS>(makeStringsLambda);
+
+            return encoding;
+        }
+    };
+
+    // Table based asymmetric numeral systems, coding each character in a fraction of a bit less than Huffman can.
+    // Each string starts with TableLog bits of state, so it suits long strings with skewed character
+    // frequencies, and is a poor fit for short strings.
+    using TansEncoder = BasicTansEncoder<>;
+
+}
+
+#endif //SQUEEZE_TANSENCODER_H
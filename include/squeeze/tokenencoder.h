@@ -0,0 +1,388 @@
+#ifndef SQUEEZE_TOKENENCODER_H
+#define SQUEEZE_TOKENENCODER_H
+
+#include <string_view>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <span>
+
+#include "concepts.h"
+#include "huffmanencoder.h"
+#include "lib/decode_iterator.h"
+
+namespace squeeze
+{
+    namespace token {
+
+        // Compile time options controlling how a TokenEncoder builds its dictionary
+        struct Options
+        {
+            // The most tokens in the dictionary. Every character used and every token needs its own byte
+            // value, so there can be no more than 256 of them together. Each token takes another pass over
+            // the strings to find, so more tokens take longer to compile.
+            std::size_t MaxTokens{128};
+
+            // The longest run of characters a token can expand to
+            std::size_t MaxTokenLength{16};
+        };
+
+        // Each dictionary entry is located by a 16 bit offset
+        using OffsetType = std::uint16_t;
+
+        // A symbol of a string: a character of the alphabet, or a token after them
+        using SymbolType = std::uint8_t;
+
+        // The strings as symbols, and the pair of symbols each token replaced, before they are stored
+        template<std::size_t TOTAL_LENGTH, std::size_t NUM_STRINGS>
+        struct Grammar
+        {
+            std::array<std::uint16_t, TOTAL_LENGTH> Symbols{};
+            std::array<std::size_t, NUM_STRINGS + 1> FirstSymbol{};     // with the total at the end
+
+            std::array<char, 256> Alphabet{};                           // the characters used, in order
+            std::size_t NumChars{0};
+
+            std::array<std::array<std::uint16_t, 2>, 256> Pairs{};      // the pair each token replaced
+            std::array<std::size_t, 256> Lengths{};                     // the characters each symbol expands to
+            std::size_t NumTokens{0};
+        };
+
+        // The tables that expand each symbol to its characters
+        struct Dictionary
+        {
+            std::span<char const> Alphabet;
+            std::span<OffsetType const> Offsets;    // where each token starts in Expansions, with the end last
+            std::span<char const> Expansions;
+
+            // the characters of a symbol
+            [[nodiscard]] constexpr std::span<char const> expand(SymbolType const &symbol) const
+            {
+                if(symbol < Alphabet.size()) {
+                    return Alphabet.subspan(symbol, 1);
+                }
+
+                auto const t = symbol - Alphabet.size();
+                return Expansions.subspan(Offsets[t], static_cast<std::size_t>(Offsets[t + 1] - Offsets[t]));
+            }
+        };
+
+
+        // Represents a string that is being accessed, expanding a symbol at a time as it is iterated.
+        class IterableString
+        {
+        private:
+            // the next symbol to expand, and the characters of the current one
+            struct Cursor
+            {
+                std::size_t Symbol{0};
+                std::span<char const> Run{};
+                std::size_t RunPosition{0};
+            };
+
+        public:
+            using Iterator = lib::decode_iterator<IterableString>;
+            friend Iterator;
+
+            constexpr IterableString(std::span<SymbolType const> symbols, std::size_t stringLength, Dictionary dictionary)
+                : m_Symbols{symbols}
+                , m_StringLength{stringLength}
+                , m_Dictionary{dictionary}
+            {}
+
+            [[nodiscard]] constexpr std::size_t size() const { return m_StringLength; }
+
+            [[nodiscard]] constexpr Iterator begin() const { return Iterator{*this}; }
+            [[nodiscard]] constexpr Iterator end() const { return Iterator{typename Iterator::EndPosition{*this}}; }
+
+            // Decode the string into dest, stopping early if dest is too small.
+            // Returns the number of characters written.
+            constexpr std::size_t decode_into(std::span<char> dest) const
+            {
+                return decode_n(dest.begin(), std::min(dest.size(), m_StringLength));
+            }
+
+            // Decode the whole string to the output iterator. Returns the number of characters written.
+            template<typename TOutputIt>
+            constexpr std::size_t copy_to(TOutputIt out) const
+            {
+                return decode_n(out, m_StringLength);
+            }
+
+        private:
+            [[nodiscard]] constexpr Cursor start() const { return Cursor{}; }
+
+            // the next character of the current symbol, expanding the next symbol when it is done
+            constexpr char next(Cursor &cursor) const
+            {
+                if(cursor.RunPosition == cursor.Run.size()) {
+                    cursor.Run = m_Dictionary.expand(m_Symbols[cursor.Symbol++]);
+                    cursor.RunPosition = 0;
+                }
+                return cursor.Run[cursor.RunPosition++];
+            }
+
+            // copy the characters of each symbol in turn
+            template<typename TOutputIt>
+            constexpr std::size_t decode_n(TOutputIt out, std::size_t count) const
+            {
+                std::size_t done{0};
+                for(auto symbol = m_Symbols.begin(); done < count; ++symbol) {
+                    auto const run = m_Dictionary.expand(*symbol);
+                    auto const n = std::min(run.size(), count - done);
+                    out = std::copy_n(run.begin(), n, out);
+                    done += n;
+                }
+                return done;
+            }
+
+            std::span<SymbolType const> m_Symbols;
+            std::size_t m_StringLength;
+            Dictionary m_Dictionary;
+        };
+
+
+        // The entries are huffman::Entry, with the first symbol of each string in FirstBit
+        template<typename TEntryIndex, std::size_t NUM_SYMBOLS, std::size_t NUM_CHARS, std::size_t NUM_TOKENS, std::size_t EXPANSIONS_LENGTH>
+        struct Encoding
+        {
+            static constexpr std::size_t NumEntries = TEntryIndex::NumEntries;
+
+            using StringType = IterableString;
+
+            constexpr StringType operator[](std::size_t idx) const
+            {
+                // bounds check without exceptions
+                if(idx >= NumEntries)
+                    return bad_string();
+
+                auto const entry = m_Entries[idx];
+                return StringType{std::span{m_Symbols}.subspan(entry.FirstBit), entry.OriginalStringLength, dictionary()};
+            }
+
+            // provide a value that is an implementation defined value representing a
+            // bad key or index was requested.
+            constexpr StringType bad_string() const {
+                // this is an empty string
+                return StringType{{}, 0, dictionary()};
+            }
+
+            TEntryIndex m_Entries;
+            std::array<SymbolType, NUM_SYMBOLS> m_Symbols;
+            std::array<char, NUM_CHARS> m_Alphabet;
+            std::array<OffsetType, NUM_TOKENS + 1> m_Offsets;
+            std::array<char, EXPANSIONS_LENGTH> m_Expansions;
+
+        private:
+            constexpr Dictionary dictionary() const
+            {
+                return Dictionary{m_Alphabet, m_Offsets, m_Expansions};
+            }
+        };
+
+
+        //
+        // Build the token dictionary by repeatedly replacing the most profitable pair of adjacent symbols
+        // with a new token, byte pair encoding style. The profit of a pair is the symbols it saves, less
+        // the characters and offset needed to store its expansion. Pairs are only counted within strings.
+        //
+        template<Options OPTIONS, std::size_t TOTAL_LENGTH, std::size_t NUM_STRINGS>
+        static constexpr auto BuildGrammar(CallableGivesIterableStringViews auto makeStringsLambda)
+        {
+            constexpr auto st = makeStringsLambda();
+
+            Grammar<TOTAL_LENGTH, NUM_STRINGS> result{};
+
+            // the alphabet is the characters used, so they take the lowest symbols
+            std::array<bool, 256> used{};
+            for(std::string_view const str : st) {
+                for(auto const c : str) {
+                    used.at(static_cast<unsigned char>(c)) = true;
+                }
+            }
+
+            std::array<std::uint16_t, 256> charSymbol{};
+            for(std::size_t c{0}; c < used.size(); ++c) {
+                if(used.at(c)) {
+                    charSymbol.at(c) = static_cast<std::uint16_t>(result.NumChars);
+                    result.Alphabet.at(result.NumChars) = static_cast<char>(c);
+                    result.Lengths.at(result.NumChars) = 1;
+                    ++result.NumChars;
+                }
+            }
+
+            std::size_t numSymbols{0};
+            std::size_t s{0};
+            for(std::string_view const str : st) {
+                result.FirstSymbol.at(s++) = numSymbols;
+                for(auto const c : str) {
+                    result.Symbols.at(numSymbols++) = charSymbol.at(static_cast<unsigned char>(c));
+                }
+            }
+            result.FirstSymbol.at(NUM_STRINGS) = numSymbols;
+
+            std::array<std::uint32_t, TOTAL_LENGTH> pairs{};
+
+            while(result.NumTokens < OPTIONS.MaxTokens && result.NumChars + result.NumTokens < 256) {
+                // gather every adjacent pair that would make a short enough token, and count them by sorting.
+                // In a run of one symbol the pairs overlap, and replacing from the left only takes every
+                // other one, so count them the same way.
+                std::size_t numPairs{0};
+                for(std::size_t str{0}; str < NUM_STRINGS; ++str) {
+                    bool countedRun{false};
+                    for(auto i = result.FirstSymbol.at(str); i + 1 < result.FirstSymbol.at(str + 1); ++i) {
+                        auto const a = result.Symbols.at(i);
+                        auto const b = result.Symbols.at(i + 1);
+                        if(a == b && countedRun) {
+                            countedRun = false;
+                            continue;
+                        }
+
+                        countedRun = false;
+                        if(result.Lengths.at(a) + result.Lengths.at(b) <= OPTIONS.MaxTokenLength) {
+                            pairs.at(numPairs++) = (std::uint32_t{a} << 16) | b;
+                            countedRun = a == b;
+                        }
+                    }
+                }
+                std::sort(pairs.begin(), pairs.begin() + static_cast<std::ptrdiff_t>(numPairs));
+
+                std::uint32_t best{0};
+                std::ptrdiff_t bestProfit{0};
+                for(std::size_t i{0}; i < numPairs;) {
+                    auto j = i;
+                    while(j < numPairs && pairs.at(j) == pairs.at(i)) {
+                        ++j;
+                    }
+
+                    auto const length = result.Lengths.at(pairs.at(i) >> 16) + result.Lengths.at(pairs.at(i) & 0xFFFFu);
+                    auto const profit = static_cast<std::ptrdiff_t>(j - i) - static_cast<std::ptrdiff_t>(length + sizeof(OffsetType));
+                    if(profit > bestProfit) {
+                        best = pairs.at(i);
+                        bestProfit = profit;
+                    }
+                    i = j;
+                }
+
+                if(bestProfit <= 0) {
+                    break;
+                }
+
+                // add the token, and replace the pair with it from the left of each string
+                auto const a = static_cast<std::uint16_t>(best >> 16);
+                auto const b = static_cast<std::uint16_t>(best & 0xFFFFu);
+                auto const tokenSymbol = static_cast<std::uint16_t>(result.NumChars + result.NumTokens);
+                result.Pairs.at(result.NumTokens) = {a, b};
+                result.Lengths.at(tokenSymbol) = result.Lengths.at(a) + result.Lengths.at(b);
+                ++result.NumTokens;
+
+                std::size_t out{0};
+                for(std::size_t str{0}; str < NUM_STRINGS; ++str) {
+                    auto const first = result.FirstSymbol.at(str);
+                    auto const last = result.FirstSymbol.at(str + 1);
+                    result.FirstSymbol.at(str) = out;
+
+                    for(auto i = first; i < last; ++i) {
+                        if(i + 1 < last && result.Symbols.at(i) == a && result.Symbols.at(i + 1) == b) {
+                            result.Symbols.at(out++) = tokenSymbol;
+                            ++i;
+                        } else {
+                            result.Symbols.at(out++) = result.Symbols.at(i);
+                        }
+                    }
+                }
+                result.FirstSymbol.at(NUM_STRINGS) = out;
+            }
+
+            return result;
+        }
+
+
+        template<Options OPTIONS = Options{}>
+        static constexpr auto MakeEncoding(CallableGivesIterableStringViews auto makeStringsLambda)
+        {
+            static_assert(OPTIONS.MaxTokenLength >= 2, "MaxTokenLength must be at least 2");
+
+            // get the string table to work with
+            constexpr auto st = makeStringsLambda();
+            constexpr auto NumStrings = static_cast<std::size_t>(std::distance(st.begin(), st.end()));
+            constexpr auto TotalLength = std::accumulate(
+                    st.begin(), st.end(), std::size_t{0},
+                    [](auto total, auto const &sv){ return total + sv.size(); });
+            constexpr auto MaxStringLength = std::accumulate(
+                    st.begin(), st.end(), std::size_t{0},
+                    [](std::size_t longest, auto const &sv){ return std::max(longest, sv.size()); });
+
+            constexpr auto grammar = BuildGrammar<OPTIONS, TotalLength, NumStrings>(makeStringsLambda);
+            constexpr auto NumSymbols = grammar.FirstSymbol.at(NumStrings);
+
+            constexpr auto ExpansionsLength = [=]() {
+                std::size_t length{0};
+                for(std::size_t t{0}; t < grammar.NumTokens; ++t) {
+                    length += grammar.Lengths.at(grammar.NumChars + t);
+                }
+                return length;
+            }();
+
+            static_assert(ExpansionsLength <= std::numeric_limits<OffsetType>::max(), "The token dictionary is too large");
+
+            using EntryIndexType = huffman::EntryIndex<NumStrings, NumSymbols, MaxStringLength>;
+            Encoding<EntryIndexType, NumSymbols, grammar.NumChars, grammar.NumTokens, ExpansionsLength> result{};
+
+            std::copy_n(grammar.Alphabet.begin(), grammar.NumChars, result.m_Alphabet.begin());
+
+            // each token expands to the expansion of its first symbol then its second. Tokens are only made
+            // from earlier symbols, so the expansions they copy are already written.
+            std::size_t offset{0};
+            for(std::size_t t{0}; t < grammar.NumTokens; ++t) {
+                result.m_Offsets.at(t) = static_cast<OffsetType>(offset);
+
+                for(auto const symbol : grammar.Pairs.at(t)) {
+                    if(symbol < grammar.NumChars) {
+                        result.m_Expansions.at(offset++) = grammar.Alphabet.at(symbol);
+                    } else {
+                        auto const from = result.m_Offsets.at(symbol - grammar.NumChars);
+                        for(std::size_t i{0}; i < grammar.Lengths.at(symbol); ++i) {
+                            result.m_Expansions.at(offset++) = result.m_Expansions.at(from + i);
+                        }
+                    }
+                }
+            }
+            result.m_Offsets.at(grammar.NumTokens) = static_cast<OffsetType>(offset);
+
+            for(std::size_t i{0}; i < NumSymbols; ++i) {
+                result.m_Symbols.at(i) = static_cast<SymbolType>(grammar.Symbols.at(i));
+            }
+
+            std::size_t s{0};
+            for(auto const &sv : st) {
+                result.m_Entries.set(s, huffman::Entry{grammar.FirstSymbol.at(s), sv.size()});
+                ++s;
+            }
+
+            return result;
+        }
+    }
+
+    template<token::Options OPTIONS = token::Options{}>
+    class BasicTokenEncoder
+    {
+    public:
+
+        static constexpr auto Compile(CallableGivesIterableStringViews auto makeStringsLambda)
+        {
+            constexpr auto const encoding = token::MakeEncoding<OPTIONS>(makeStringsLambda);
+
+            return encoding;
+        }
+    };
+
+    // Byte pair encoding, with each byte of a string expanding to a character or a run of characters
+    using TokenEncoder = BasicTokenEncoder<>;
+
+}
+
+#endif //SQUEEZE_TOKENENCODER_H
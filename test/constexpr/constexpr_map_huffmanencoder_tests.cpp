@@ -75,3 +75,29 @@ SCENARIO("StringMap<HuffmanEncoder> can be compile-time initialised", "[StringMa
 
     }
 }
+
+SCENARIO("StringMap<FastHuffmanEncoder> can be decoded at compile time", "[StringMap][HuffmanEncoder]")
+{
+    GIVEN("A constexpr StringMap<FastHuffmanEncoder>") {
+        static constexpr auto map = StringMap<Key, FastHuffmanEncoder>(buildMapStrings);
+
+        THEN("A string can be decoded in bulk at compile time") {
+            constexpr auto decoded = [] {
+                std::array<char, 12> buffer{};
+                map.decode_into(Key::String_3, buffer);
+                return buffer;
+            }();
+
+            STATIC_REQUIRE(std::string_view{decoded.data(), decoded.size()} == "Third String");
+        }
+
+        THEN("An absent key decodes nothing at compile time") {
+            constexpr auto count = [] {
+                std::array<char, 12> buffer{};
+                return map.decode_into(Key::String_2, buffer);
+            }();
+
+            STATIC_REQUIRE(count == 0);
+        }
+    }
+}
@@ -0,0 +1,101 @@
+#include <catch2/catch.hpp>
+#include <string>
+
+#include <squeeze/squeeze.h>
+
+using Catch::Matchers::Equals;
+using namespace squeeze;
+
+enum class Key {
+    String_1,
+    String_2,
+    String_3
+};
+
+static constexpr auto buildMapStrings = [] {
+    return std::to_array<KeyedStringView<Key>> ({
+        // out of order and missing a value
+        {Key::String_3, "Third String"},
+        {Key::String_1, "First String"},
+    });
+};
+
+
+SCENARIO("StringMap<PerfectHashLookup> can be compile-time initialised", "[StringMap][PerfectHashLookup]")
+{
+    GIVEN("A constexpr StringMap with a perfect hash lookup") {
+        static constexpr auto map = StringMap<Key, NilEncoder, PerfectHashLookup>(buildMapStrings);
+
+        THEN("Keys can be found at compile time") {
+            STATIC_REQUIRE(map.contains(Key::String_1));
+            STATIC_REQUIRE_FALSE(map.contains(Key::String_2));
+            STATIC_REQUIRE(map.get(Key::String_3) == "Third String");
+        }
+    }
+}
+
+
+SCENARIO("StringMap<DenseLookup> can be compile-time initialised", "[StringMap][DenseLookup]")
+{
+    GIVEN("A constexpr StringMap with a dense lookup") {
+        static constexpr auto map = StringMap<Key, NilEncoder, DenseLookup>(buildMapStrings);
+
+        THEN("Keys can be found at compile time") {
+            STATIC_REQUIRE(map.contains(Key::String_1));
+            STATIC_REQUIRE_FALSE(map.contains(Key::String_2));
+            STATIC_REQUIRE(map.get(Key::String_3) == "Third String");
+        }
+    }
+}
+
+
+SCENARIO("StringMap<EytzingerLookup> can be compile-time initialised", "[StringMap][EytzingerLookup]")
+{
+    GIVEN("A constexpr StringMap with an Eytzinger lookup") {
+        static constexpr auto map = StringMap<Key, NilEncoder, EytzingerLookup>(buildMapStrings);
+
+        THEN("Keys can be found at compile time") {
+            STATIC_REQUIRE(map.contains(Key::String_1));
+            STATIC_REQUIRE_FALSE(map.contains(Key::String_2));
+            STATIC_REQUIRE(map.get(Key::String_3) == "Third String");
+        }
+
+        THEN("try_get() can be used at compile time") {
+            STATIC_REQUIRE(map.try_get(Key::String_1) == "First String");
+            STATIC_REQUIRE_FALSE(map.try_get(Key::String_2).has_value());
+        }
+    }
+}
+
+
+SCENARIO("StringMap<PackedLookup> can be compile-time initialised", "[StringMap][PackedLookup]")
+{
+    GIVEN("A constexpr StringMap with a packed lookup") {
+        static constexpr auto map = StringMap<Key, NilEncoder, PackedLookup>(buildMapStrings);
+
+        THEN("Keys can be found at compile time") {
+            STATIC_REQUIRE(map.get(Key::String_1) == "First String");
+            STATIC_REQUIRE_FALSE(map.contains(Key::String_2));
+            STATIC_REQUIRE(map.get(Key::String_3) == "Third String");
+        }
+    }
+}
+
+SCENARIO("StringMap with string keys can be compile-time initialised", "[StringMap][PerfectHashLookup]")
+{
+    GIVEN("A constexpr StringMap with string keys and a perfect hash lookup") {
+        static constexpr auto map = StringMap<std::string_view, NilEncoder, PerfectHashLookup>([] {
+            return std::to_array<KeyedStringView<std::string_view>>({
+                {"verbose", "Print more detail"},
+                {"quiet", "Print nothing"},
+                {"colour", "Colour the output"},
+            });
+        });
+
+        THEN("Keys can be found at compile time") {
+            STATIC_REQUIRE(map.get("quiet") == "Print nothing");
+            STATIC_REQUIRE(map.contains("colour"));
+            STATIC_REQUIRE_FALSE(map.contains("color"));
+        }
+    }
+}
@@ -0,0 +1,37 @@
+#include <catch2/catch.hpp>
+#include <string>
+
+#include <squeeze/squeeze.h>
+
+using namespace squeeze;
+
+enum class Code {
+    Ok,
+    Warning_1,
+    Warning_2,
+    Error_1,
+    Error_2,
+    Error_3
+};
+
+static constexpr auto buildRangeStrings = [] {
+    return std::to_array<KeyedRangeStringView<Code>>({
+        {Code::Error_1, Code::Error_3, "Error"},
+        {Code::Warning_1, Code::Warning_2, "Warning"},
+    });
+};
+
+
+SCENARIO("StringRangeMap can be compile-time initialised", "[StringRangeMap]")
+{
+    GIVEN("A constexpr StringRangeMap") {
+        static constexpr auto map = StringRangeMap<Code, NilEncoder>(buildRangeStrings);
+
+        THEN("Keys can be found at compile time") {
+            STATIC_REQUIRE(map.count() == 2);
+            STATIC_REQUIRE(map.get(Code::Warning_2) == "Warning");
+            STATIC_REQUIRE(map.get(Code::Error_2) == "Error");
+            STATIC_REQUIRE_FALSE(map.contains(Code::Ok));
+        }
+    }
+}
@@ -0,0 +1,45 @@
+#include <catch2/catch.hpp>
+#include <tuple>
+
+#include <squeeze/squeeze.h>
+
+using namespace squeeze;
+
+static constexpr auto buildTableStrings = [] {
+    return std::to_array<std::string_view> ({
+        "failed to open connection",
+        "failed to close connection",
+        "failed to read connection",
+        "",
+    });
+};
+
+// compare a decoded string at compile time
+static constexpr bool Equal(auto const &str, std::string_view expected)
+{
+    return str.size() == expected.size() && std::equal(expected.begin(), expected.end(), str.begin());
+}
+
+// every encoder that must work at compile time
+using Encoders = std::tuple<
+    LzEncoder,
+    HuffmanLzEncoder,
+    TokenEncoder,
+    FsstEncoder,
+    TansEncoder,
+    ContextHuffmanEncoder,
+    AutoEncoder<>,
+    HybridEncoder
+>;
+
+
+TEMPLATE_LIST_TEST_CASE("StringTable can be compile-time initialised with each encoder", "[StringTable]", Encoders)
+{
+    static constexpr auto table = StringTable<TestType>(buildTableStrings);
+
+    STATIC_REQUIRE(table.count() == 4);
+    STATIC_REQUIRE(Equal(table[0], "failed to open connection"));
+    STATIC_REQUIRE(Equal(table[1], "failed to close connection"));
+    STATIC_REQUIRE(Equal(table[2], "failed to read connection"));
+    STATIC_REQUIRE(table[3].size() == 0);
+}
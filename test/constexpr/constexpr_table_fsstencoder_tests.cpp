@@ -0,0 +1,36 @@
+#include <catch2/catch.hpp>
+
+#include <squeeze/squeeze.h>
+
+using namespace squeeze;
+
+static constexpr auto buildTableStrings = [] {
+    return std::to_array<std::string_view> ({
+        "failed to open connection",
+        "failed to close connection",
+        "failed to read connection",
+        "",
+    });
+};
+
+// compare a decoded string at compile time
+static constexpr bool Equal(auto const &str, std::string_view expected)
+{
+    return str.size() == expected.size() && std::equal(expected.begin(), expected.end(), str.begin());
+}
+
+
+SCENARIO("An FSST symbol table encoding can be compile-time initialised", "[FsstEncoder]")
+{
+    GIVEN("A constexpr symbol table encoding") {
+        // built directly, as a table this small is stored uncompressed by FsstEncoder
+        static constexpr auto table = fsst::MakeEncoding(buildTableStrings);
+
+        THEN("Strings can be decoded at compile time") {
+            STATIC_REQUIRE(Equal(table[0], "failed to open connection"));
+            STATIC_REQUIRE(Equal(table[1], "failed to close connection"));
+            STATIC_REQUIRE(Equal(table[2], "failed to read connection"));
+            STATIC_REQUIRE(table[3].size() == 0);
+        }
+    }
+}
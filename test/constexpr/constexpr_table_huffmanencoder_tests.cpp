@@ -189,3 +189,151 @@ SCENARIO("StringTable<HuffmanEncoder> can be compile-time initialised", "[String
 */
     }
 }
+
+SCENARIO("StringTable<TableHuffmanEncoder> can be compile-time initialised", "[StringTable][HuffmanEncoder]") {
+    GIVEN("A compile-time initialised StringTable<TableHuffmanEncoder>"){
+        static constinit auto table = StringTable<TableHuffmanEncoder>(buildTableStrings);
+
+        THEN("The number of strings should be correct"){
+            STATIC_REQUIRE(table.count() == 3);
+        }
+
+        THEN("All strings should match the source data") {
+            auto sourceTable = buildTableStrings();
+            for(std::size_t i{0}; i < sourceTable.size(); ++i) {
+                auto s = table[i];
+                auto expected = std::string{sourceTable[i]};
+
+                std::string extracted{s.begin(), s.end()};
+
+                REQUIRE(s.size() == expected.size());
+                REQUIRE_THAT(extracted, Equals(expected));
+            }
+        }
+    }
+}
+
+SCENARIO("StringTable<CanonicalHuffmanEncoder> can be compile-time initialised", "[StringTable][HuffmanEncoder]") {
+    GIVEN("A compile-time initialised StringTable<CanonicalHuffmanEncoder>"){
+        static constinit auto table = StringTable<CanonicalHuffmanEncoder>(buildTableStrings);
+
+        THEN("The number of strings should be correct"){
+            STATIC_REQUIRE(table.count() == 3);
+        }
+
+        THEN("All strings should match the source data") {
+            auto sourceTable = buildTableStrings();
+            for(std::size_t i{0}; i < sourceTable.size(); ++i) {
+                auto s = table[i];
+                auto expected = std::string{sourceTable[i]};
+
+                std::string extracted{s.begin(), s.end()};
+
+                REQUIRE(s.size() == expected.size());
+                REQUIRE_THAT(extracted, Equals(expected));
+            }
+        }
+    }
+}
+
+SCENARIO("StringTable<FastHuffmanEncoder> can be compile-time initialised", "[StringTable][HuffmanEncoder]") {
+    GIVEN("A compile-time initialised StringTable<FastHuffmanEncoder>"){
+        static constinit auto table = StringTable<FastHuffmanEncoder>(buildTableStrings);
+
+        THEN("The number of strings should be correct"){
+            STATIC_REQUIRE(table.count() == 3);
+        }
+
+        THEN("Strings can be decoded at compile time") {
+            static constexpr auto constTable = StringTable<FastHuffmanEncoder>(buildTableStrings);
+            STATIC_REQUIRE(*constTable[0].begin() == 'T');
+            STATIC_REQUIRE(*constTable[2].begin() == 'A');
+        }
+
+        THEN("All strings should match the source data") {
+            auto sourceTable = buildTableStrings();
+            for(std::size_t i{0}; i < sourceTable.size(); ++i) {
+                auto s = table[i];
+                auto expected = std::string{sourceTable[i]};
+
+                std::string extracted{s.begin(), s.end()};
+
+                REQUIRE(s.size() == expected.size());
+                REQUIRE_THAT(extracted, Equals(expected));
+            }
+        }
+    }
+}
+
+SCENARIO("StringTable<BasicHuffmanEncoder> with interleaved strings can be compile-time initialised", "[StringTable][HuffmanEncoder]") {
+    using InterleavedEncoder = BasicHuffmanEncoder<huffman::Options{
+        .LookupBits = 8, .MaxCodeLength = 12, .Decoder = huffman::DecodeMode::Fast, .InterleaveThreshold = 64}>;
+
+    GIVEN("A compile-time initialised table of interleaved strings"){
+        static constinit auto table = StringTable<InterleavedEncoder>(buildTableStrings);
+
+        THEN("Strings can be decoded at compile time") {
+            static constexpr auto constTable = StringTable<InterleavedEncoder>(buildTableStrings);
+            static constexpr auto firstChars = [] {
+                std::array<char, 6> result{};
+                constTable[1].decode_into(result);
+                return result;
+            }();
+            STATIC_REQUIRE(firstChars == std::array{'T', 'h', 'i', 'n', 'k', ' '});
+        }
+
+        THEN("All strings should match the source data") {
+            auto sourceTable = buildTableStrings();
+            for(std::size_t i{0}; i < sourceTable.size(); ++i) {
+                auto s = table[i];
+                auto expected = std::string{sourceTable[i]};
+
+                std::string extracted{s.begin(), s.end()};
+
+                REQUIRE(s.size() == expected.size());
+                REQUIRE_THAT(extracted, Equals(expected));
+            }
+        }
+    }
+}
+
+SCENARIO("StringTable<BasicHuffmanEncoder> with checkpoints can be accessed at compile time", "[StringTable][HuffmanEncoder]") {
+    using CheckpointEncoder = BasicHuffmanEncoder<huffman::Options{
+        .LookupBits = 8, .MaxCodeLength = 12, .Decoder = huffman::DecodeMode::Fast, .CheckpointInterval = 32}>;
+
+    GIVEN("A compile-time initialised table with checkpoints"){
+        static constexpr auto table = StringTable<CheckpointEncoder>(buildTableStrings);
+        static constexpr auto source = buildTableStrings();
+
+        THEN("Characters can be accessed at compile time") {
+            STATIC_REQUIRE(table[0].at(0) == source[0][0]);
+            STATIC_REQUIRE(table[0].at(100) == source[0][100]);
+            STATIC_REQUIRE(table[2].at(source[2].size() - 1) == source[2].back());
+        }
+
+        THEN("Substrings can be decoded at compile time") {
+            static constexpr auto sub = [] {
+                std::array<char, 5> result{};
+                table[1].substr(6).decode_into(result);
+                return result;
+            }();
+            STATIC_REQUIRE(sub == std::array{'n', 'o', 't', ' ', 'I'});
+        }
+    }
+}
+
+SCENARIO("StringTable<HuffmanEncoder> shares suffixes at compile time", "[StringTable][HuffmanEncoder]") {
+    static constexpr auto makeStrings = [] {
+        return std::to_array<std::string_view>({"error", "parse error", "parse error", "ok", "not ok"});
+    };
+
+    GIVEN("A compile-time initialised table of duplicates and suffixes"){
+        static constexpr auto table = StringTable<FastHuffmanEncoder>(makeStrings);
+
+        THEN("Shared strings can be accessed at compile time") {
+            STATIC_REQUIRE(table[0].at(0) == 'e');
+            STATIC_REQUIRE(table[2].at(6) == 'e');
+            STATIC_REQUIRE(table[3].at(1) == 'k');
+        }
+    }
+}
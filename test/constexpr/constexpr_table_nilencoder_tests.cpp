@@ -46,3 +46,19 @@ SCENARIO("StringTable<NilEncoder> can be compile-time initialised", "[StringTabl
         }
     }
 }
+
+SCENARIO("StringTable<NilEncoder> shares suffixes at compile time", "[StringTable][NilEncoder]") {
+    static constexpr auto makeStrings = [] {
+        return std::to_array<std::string_view>({"error", "parse error", "parse error", "ok", "not ok"});
+    };
+
+    GIVEN("A compile-time initialised table of duplicates and suffixes"){
+        static constexpr auto table = StringTable<NilEncoder>(makeStrings);
+
+        THEN("Shared strings should match the source data") {
+            STATIC_REQUIRE(table[0] == "error");
+            STATIC_REQUIRE(table[2] == "parse error");
+            STATIC_REQUIRE(table[3] == "ok");
+        }
+    }
+}
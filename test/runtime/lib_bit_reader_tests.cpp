@@ -0,0 +1,89 @@
+#include <catch2/catch.hpp>
+#include <squeeze/lib/bit_stream.h>
+#include <squeeze/lib/bit_reader.h>
+
+using namespace squeeze;
+
+SCENARIO("lib:bit_reader reads the bits of a bit_stream") {
+    GIVEN("A bit_stream with values written through it") {
+        lib::bit_stream<300> bs;
+        bs.write(3, 0x5, 3);
+        bs.write(6, 0x1234'5678'9ABC'DEFull, 57);
+        bs.write(63, 0x2A, 6);
+        bs.write(290, 0x3FF, 10);
+
+        WHEN("A reader starts part way into a byte") {
+            lib::bit_reader reader{bs.data(), 3};
+
+            THEN("the values are read back in order") {
+                REQUIRE(reader.read(3) == 0x5);
+                REQUIRE(reader.peek(57) == 0x1234'5678'9ABC'DEFull);
+                REQUIRE(reader.read(57) == 0x1234'5678'9ABC'DEFull);
+                REQUIRE(reader.read(6) == 0x2A);
+            }
+        }
+
+        WHEN("A reader is used one bit at a time") {
+            lib::bit_reader reader{bs.data(), 0};
+
+            THEN("each bit matches the bit_stream") {
+                for(std::size_t i{0}; i < bs.size(); ++i) {
+                    REQUIRE(reader.read(1) == (bs.at(i) ? 1u : 0u));
+                }
+            }
+        }
+
+        WHEN("A reader reads past the end of the stream") {
+            lib::bit_reader reader{bs.data(), 290};
+
+            THEN("the missing bits read as zero") {
+                REQUIRE(reader.read(10) == 0x3FF);
+                REQUIRE(reader.read(40) == 0);
+            }
+        }
+    }
+
+    GIVEN("A bit_stream long enough to refill with whole words") {
+        constexpr std::uint64_t first{0x1'5A'5A5A'5A5A'5A5Aull};
+        lib::bit_stream<512> bs;
+        bs.write(5, first, lib::bit_reader::MaxPeekBits);
+        bs.write(5 + lib::bit_reader::MaxPeekBits, 0xC7, 8);
+        bs.write(5 + lib::bit_reader::MaxPeekBits + 8, first, lib::bit_reader::MaxPeekBits);
+        bs.write(5 + 2 * lib::bit_reader::MaxPeekBits + 8, 0x3C, 8);
+
+        WHEN("MaxPeekBits are read from an unaligned start") {
+            lib::bit_reader reader{bs.data(), 5};
+
+            THEN("the reads that follow are still correct") {
+                REQUIRE(reader.read(lib::bit_reader::MaxPeekBits) == first);
+                REQUIRE(reader.read(8) == 0xC7);
+                REQUIRE(reader.read(lib::bit_reader::MaxPeekBits) == first);
+                REQUIRE(reader.read(8) == 0x3C);
+            }
+        }
+
+        WHEN("MaxPeekBits are read from the first bit") {
+            lib::bit_reader reader{bs.data(), 0};
+
+            THEN("the reads that follow are still correct") {
+                REQUIRE(reader.read(lib::bit_reader::MaxPeekBits) == (first << 5 & ((std::uint64_t{1} << lib::bit_reader::MaxPeekBits) - 1)));
+                REQUIRE(reader.read(8) == ((first >> 52 | 0xC7 << 5) & 0xFF));
+                REQUIRE(reader.read(8) == ((0xC7 >> 3 | first << 5) & 0xFF));
+            }
+        }
+    }
+
+    GIVEN("A bit_reader used at compile time") {
+        constexpr auto value = [] {
+            lib::bit_stream<128> bs;
+            bs.write(70, 0xBEEF, 16);
+            lib::bit_reader reader{bs.data(), 62};
+            reader.consume(8);
+            return reader.read(16);
+        }();
+
+        THEN("the value is read at compile time") {
+            STATIC_REQUIRE(value == 0xBEEF);
+        }
+    }
+}
@@ -115,3 +115,109 @@ SCENARIO("lib:bit_stream can set and clear bits") {
 
     }
 }
+
+SCENARIO("lib:bit_stream can use wider storage words") {
+    GIVEN("bit_streams with 32 and 64 bit storage") {
+        lib::bit_stream<1, std::uint32_t> bs32;
+        lib::bit_stream<65, std::uint64_t> bs64;
+
+        THEN("the sizes should match to the nearest storage word") {
+            REQUIRE(sizeof(bs32) == 4);
+            REQUIRE(sizeof(bs64) == 16);
+        }
+
+        WHEN("The last bit of a 64 bit word is set"){
+            bs64.set(63);
+
+            THEN("we should see it set, and its neighbours clear") {
+                REQUIRE(bs64.at(62) == false);
+                REQUIRE(bs64.at(63) == true);
+                REQUIRE(bs64.at(64) == false);
+            }
+        }
+    }
+}
+
+SCENARIO("lib:bit_stream can peek, read and write runs of bits") {
+    GIVEN("A byte stored bit_stream") {
+        lib::bit_stream<100> bs;
+
+        WHEN("A value is written across byte boundaries") {
+            bs.write(5, 0x1234'5678'9ABCull, 48);
+
+            THEN("peeking the same bits gives the value back") {
+                REQUIRE(bs.peek(5, 48) == 0x1234'5678'9ABCull);
+            }
+
+            THEN("the bits are stored least significant first") {
+                REQUIRE(bs.at(4) == false);
+                REQUIRE(bs.at(5) == false);     // 0xC = 1100
+                REQUIRE(bs.at(6) == false);
+                REQUIRE(bs.at(7) == true);
+                REQUIRE(bs.at(8) == true);
+                REQUIRE(bs.peek(5, 4) == 0xC);
+            }
+
+            THEN("reading moves the position past the bits read") {
+                std::size_t pos{5};
+                REQUIRE(bs.read(pos, 12) == 0xABC);
+                REQUIRE(pos == 17);
+                REQUIRE(bs.read(pos, 36) == 0x1'2345'6789ull);
+                REQUIRE(pos == 53);
+            }
+
+            AND_WHEN("Part of the value is overwritten") {
+                bs.write(9, 0, 8);
+
+                THEN("only those bits change") {
+                    REQUIRE(bs.peek(5, 48) == 0x1234'5678'900Cull);
+                }
+            }
+        }
+
+        WHEN("All 64 bits are written") {
+            bs.write(30, ~std::uint64_t{0}, 64);
+
+            THEN("all 64 bits can be peeked") {
+                REQUIRE(bs.peek(30, 64) == ~std::uint64_t{0});
+                REQUIRE(bs.at(29) == false);
+                REQUIRE(bs.at(94) == false);
+            }
+        }
+
+        WHEN("Bits past the end of the stream are peeked") {
+            bs.write(96, 0xF, 4);
+
+            THEN("they read as zero") {
+                REQUIRE(bs.peek(96, 16) == 0xF);
+                REQUIRE(bs.peek(200, 8) == 0);
+            }
+        }
+    }
+
+    GIVEN("A 64 bit word stored bit_stream") {
+        lib::bit_stream<200, std::uint64_t> bs;
+
+        WHEN("A value is written across a word boundary") {
+            bs.write(60, 0xDEAD'BEEFull, 32);
+
+            THEN("peeking the same bits gives the value back") {
+                REQUIRE(bs.peek(60, 32) == 0xDEAD'BEEFull);
+                REQUIRE(bs.peek(64, 8) == 0xEE);
+            }
+        }
+    }
+
+    GIVEN("A bit_stream used at compile time") {
+        constexpr auto bs = [] {
+            lib::bit_stream<128, std::uint32_t> s;
+            s.write(17, 0x0123'4567'89AB'CDEFull, 64);
+            return s;
+        }();
+
+        THEN("the values can be peeked at compile time") {
+            STATIC_REQUIRE(bs.peek(17, 64) == 0x0123'4567'89AB'CDEFull);
+            STATIC_REQUIRE(bs.peek(17, 4) == 0xF);
+        }
+    }
+}
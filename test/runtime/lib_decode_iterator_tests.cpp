@@ -0,0 +1,88 @@
+#include <catch2/catch.hpp>
+#include <squeeze/lib/decode_iterator.h>
+
+#include <string>
+#include <string_view>
+
+using namespace squeeze;
+
+namespace {
+    // decodes a string stored with each character one higher, counting the characters decoded
+    class ShiftedString
+    {
+    public:
+        struct Cursor
+        {
+            std::size_t Position{0};
+        };
+
+        using Iterator = lib::decode_iterator<ShiftedString>;
+
+        constexpr ShiftedString(std::string_view stored, std::size_t *decoded) : m_Stored{stored}, m_Decoded{decoded} {}
+
+        [[nodiscard]] constexpr std::size_t size() const { return m_Stored.size(); }
+
+        [[nodiscard]] constexpr Iterator begin() const { return Iterator{*this}; }
+        [[nodiscard]] constexpr Iterator end() const { return Iterator{typename Iterator::EndPosition{*this}}; }
+
+        [[nodiscard]] constexpr Cursor start() const { return Cursor{}; }
+
+        constexpr char next(Cursor &cursor) const
+        {
+            if(m_Decoded != nullptr) {
+                ++*m_Decoded;
+            }
+            return static_cast<char>(m_Stored[cursor.Position++] - 1);
+        }
+
+    private:
+        std::string_view m_Stored;
+        std::size_t *m_Decoded;
+    };
+}
+
+
+SCENARIO("lib::decode_iterator decodes a character at a time") {
+    GIVEN("A string decoded through the iterator") {
+        std::size_t decoded{0};
+        ShiftedString const str{"ifmmp", &decoded};
+
+        THEN("Iterating gives the decoded characters") {
+            REQUIRE(std::string{str.begin(), str.end()} == "hello");
+        }
+
+        THEN("Each character is decoded once, and never past the end") {
+            for(auto it = str.begin(); it != str.end(); it++) {}
+            REQUIRE(decoded == str.size());
+        }
+
+        THEN("Post increment gives the character before the step") {
+            auto it = str.begin();
+            REQUIRE(*it++ == 'h');
+            REQUIRE(*it == 'e');
+        }
+    }
+
+    GIVEN("An empty string") {
+        std::size_t decoded{0};
+        ShiftedString const str{"", &decoded};
+
+        THEN("The begin iterator is the end iterator, and nothing is decoded") {
+            REQUIRE(str.begin() == str.end());
+            REQUIRE(decoded == 0);
+        }
+    }
+
+    GIVEN("A string decoded at compile time") {
+        constexpr auto first = [] {
+            ShiftedString const str{"bcd", nullptr};
+            auto it = str.begin();
+            ++it;
+            return *it;
+        }();
+
+        THEN("The value is decoded at compile time") {
+            STATIC_REQUIRE(first == 'b');
+        }
+    }
+}
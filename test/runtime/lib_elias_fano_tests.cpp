@@ -0,0 +1,65 @@
+#include <catch2/catch.hpp>
+#include <squeeze/lib/elias_fano.h>
+
+using namespace squeeze;
+
+// a non-decreasing sequence with repeats, small steps and occasional large gaps
+static constexpr std::uint64_t SequenceValue(std::size_t i)
+{
+    return (i / 2) * 7 + (i / 3) * (i / 3) + (i / 50) * 5000;
+}
+
+SCENARIO("lib::elias_fano stores non-decreasing values") {
+    GIVEN("An elias_fano with more values than one select sample covers") {
+        constexpr std::size_t NumValues = 300;
+        constexpr auto MaxValue = SequenceValue(NumValues - 1);
+
+        lib::elias_fano<NumValues, MaxValue> ef;
+        for(std::size_t i{0}; i < NumValues; ++i) {
+            ef.set(i, SequenceValue(i));
+        }
+
+        THEN("Every value should be returned") {
+            for(std::size_t i{0}; i < NumValues; ++i) {
+                REQUIRE(ef[i] == SequenceValue(i));
+            }
+        }
+
+        THEN("It should be smaller than an array of the values") {
+            REQUIRE(sizeof(ef) * 2 < NumValues * sizeof(std::uint32_t));
+        }
+    }
+
+    GIVEN("An elias_fano with repeated values") {
+        lib::elias_fano<5, 10> ef;
+        ef.set(0, 0);
+        ef.set(1, 0);
+        ef.set(2, 4);
+        ef.set(3, 4);
+        ef.set(4, 10);
+
+        THEN("The repeated values should be returned") {
+            REQUIRE(ef[0] == 0);
+            REQUIRE(ef[1] == 0);
+            REQUIRE(ef[2] == 4);
+            REQUIRE(ef[3] == 4);
+            REQUIRE(ef[4] == 10);
+        }
+    }
+
+    GIVEN("An elias_fano built at compile time") {
+        static constexpr auto ef = [] {
+            lib::elias_fano<100, 100000> result;
+            for(std::size_t i{0}; i < 100; ++i) {
+                result.set(i, i * i * 10);
+            }
+            return result;
+        }();
+
+        THEN("Values can be read at compile time") {
+            STATIC_REQUIRE(ef[0] == 0);
+            STATIC_REQUIRE(ef[65] == 65 * 65 * 10);
+            STATIC_REQUIRE(ef[99] == 99 * 99 * 10);
+        }
+    }
+}
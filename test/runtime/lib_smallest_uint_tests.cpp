@@ -0,0 +1,19 @@
+#include <catch2/catch.hpp>
+#include <squeeze/lib/smallest_uint.h>
+
+using namespace squeeze;
+
+
+SCENARIO("lib::smallest_uint_t selects the narrowest type") {
+    GIVEN("Maximum values at the edges of each type") {
+        THEN("The narrowest type holding the value should be chosen") {
+            STATIC_REQUIRE(std::is_same_v<lib::smallest_uint_t<0>, std::uint8_t>);
+            STATIC_REQUIRE(std::is_same_v<lib::smallest_uint_t<0xFF>, std::uint8_t>);
+            STATIC_REQUIRE(std::is_same_v<lib::smallest_uint_t<0x100>, std::uint16_t>);
+            STATIC_REQUIRE(std::is_same_v<lib::smallest_uint_t<0xFFFF>, std::uint16_t>);
+            STATIC_REQUIRE(std::is_same_v<lib::smallest_uint_t<0x10000>, std::uint32_t>);
+            STATIC_REQUIRE(std::is_same_v<lib::smallest_uint_t<0xFFFFFFFF>, std::uint32_t>);
+            STATIC_REQUIRE(std::is_same_v<lib::smallest_uint_t<0x100000000>, std::uint64_t>);
+        }
+    }
+}
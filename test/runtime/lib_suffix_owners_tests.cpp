@@ -0,0 +1,40 @@
+#include <catch2/catch.hpp>
+#include <squeeze/lib/suffix_owners.h>
+
+using namespace squeeze;
+
+
+SCENARIO("lib::suffix_owners finds the string each string can be read from") {
+    GIVEN("Strings with duplicates and suffixes") {
+        constexpr auto strings = std::to_array<std::string_view>({"error", "parse error", "ok", "parse error", "rror", "not ok", "x"});
+        constexpr auto owners = lib::suffix_owners<strings.size()>(strings);
+
+        THEN("Suffixes should be owned by the longest string that ends with them") {
+            STATIC_REQUIRE(owners[0] == 1);
+            STATIC_REQUIRE(owners[4] == 1);
+            STATIC_REQUIRE(owners[2] == 5);
+        }
+
+        THEN("The first of identical strings should own the others") {
+            STATIC_REQUIRE(owners[1] == 1);
+            STATIC_REQUIRE(owners[3] == 1);
+        }
+
+        THEN("Strings that are not suffixes should own themselves") {
+            STATIC_REQUIRE(owners[5] == 5);
+            STATIC_REQUIRE(owners[6] == 6);
+        }
+    }
+
+    GIVEN("Strings that can't be merged with others") {
+        constexpr auto strings = std::to_array<std::string_view>({"error", "parse error", "error", "ok"});
+        constexpr auto owners = lib::suffix_owners<strings.size()>(strings, [](std::size_t idx) { return idx != 1; });
+
+        THEN("Only their duplicates should share them") {
+            STATIC_REQUIRE(owners[0] == 0);
+            STATIC_REQUIRE(owners[1] == 1);
+            STATIC_REQUIRE(owners[2] == 0);
+            STATIC_REQUIRE(owners[3] == 3);
+        }
+    }
+}
@@ -75,3 +75,37 @@ SCENARIO("StringMap<HuffmanEncoder> Can provide the correct strings", "[StringMa
 
     }
 }
+
+SCENARIO("StringMap<HuffmanEncoder> can decode whole strings in bulk", "[StringMap][HuffmanEncoder]")
+{
+    GIVEN("A runtime initialised StringMap<HuffmanEncoder>") {
+        auto const map = StringMap<Key, HuffmanEncoder>(buildMapStrings);
+
+        WHEN("A present key is decoded into a buffer") {
+            std::array<char, 32> buffer{};
+            auto const n = map.decode_into(Key::String_3, buffer);
+
+            THEN("The string should be written") {
+                REQUIRE_THAT((std::string{buffer.data(), n}), Equals("Third String"));
+            }
+        }
+
+        WHEN("A present key is copied to an output iterator") {
+            std::string extracted;
+            auto const n = map.copy_to(Key::String_1, std::back_inserter(extracted));
+
+            THEN("The string should be written") {
+                REQUIRE(n == extracted.size());
+                REQUIRE_THAT(extracted, Equals("First String"));
+            }
+        }
+
+        WHEN("An absent key is decoded") {
+            std::array<char, 32> buffer{};
+
+            THEN("Nothing should be written") {
+                REQUIRE(map.decode_into(Key::String_2, buffer) == 0);
+            }
+        }
+    }
+}
@@ -0,0 +1,413 @@
+#include <catch2/catch.hpp>
+#include <string>
+#include <limits>
+#include <type_traits>
+
+#include <squeeze/squeeze.h>
+
+using Catch::Matchers::Equals;
+using namespace squeeze;
+
+enum class Key {
+    String_1,
+    String_2,
+    String_3
+};
+
+static auto buildMapStrings = [] {
+    return std::to_array<KeyedStringView<Key>> ({
+        // out of order and missing a value
+        {Key::String_3, "Third String"},
+        {Key::String_1, "First String"},
+    });
+};
+
+static constexpr auto Messages = std::to_array<std::string_view>({
+    "Not found", "Permission denied", "Timed out", "Bad request", "Out of memory", "Device busy", "Retry later"
+});
+
+// a sparse set of error codes, including negative values
+static constexpr int ErrorCode(std::size_t i)
+{
+    return static_cast<int>(i * i * 37 + i * 1001) - 50000;
+}
+
+static constexpr std::size_t NumErrorCodes = 500;
+
+static auto buildErrorStrings = [] {
+    std::array<KeyedStringView<int>, NumErrorCodes> result{};
+    for(std::size_t i{0}; i < result.size(); ++i) {
+        result.at(i) = {ErrorCode(i), Messages.at(i % Messages.size())};
+    }
+    return result;
+};
+
+
+SCENARIO("StringMap<PerfectHashLookup> can find strings", "[StringMap][PerfectHashLookup]")
+{
+    GIVEN("A StringMap with enum keys and a perfect hash lookup") {
+        auto const map = StringMap<Key, HuffmanEncoder, PerfectHashLookup>(buildMapStrings);
+
+        THEN("The number of strings should be correct") {
+            REQUIRE(map.count() == 2);
+        }
+
+        THEN("The present keys should be found") {
+            REQUIRE(map.contains(Key::String_1));
+            REQUIRE(map.contains(Key::String_3));
+
+            auto const s = map.get(Key::String_3);
+            REQUIRE_THAT((std::string{s.begin(), s.end()}), Equals("Third String"));
+        }
+
+        THEN("The missing key should not be found") {
+            REQUIRE_FALSE(map.contains(Key::String_2));
+            REQUIRE(map.get(Key::String_2).size() == 0);
+        }
+    }
+
+    GIVEN("A StringMap of many sparse integer keys and a perfect hash lookup") {
+        auto const map = StringMap<int, HuffmanEncoder, PerfectHashLookup>(buildErrorStrings);
+
+        THEN("Every key should give its string") {
+            for(std::size_t i{0}; i < NumErrorCodes; ++i) {
+                REQUIRE(map.contains(ErrorCode(i)));
+
+                auto const s = map.get(ErrorCode(i));
+                REQUIRE_THAT((std::string{s.begin(), s.end()}), Equals(std::string{Messages.at(i % Messages.size())}));
+            }
+        }
+
+        THEN("Keys between the codes should not be found") {
+            for(std::size_t i{0}; i < NumErrorCodes; ++i) {
+                REQUIRE_FALSE(map.contains(ErrorCode(i) + 1));
+            }
+        }
+
+        THEN("It should find the same strings as a sorted lookup") {
+            auto const sorted = StringMap<int, HuffmanEncoder, SortedLookup>(buildErrorStrings);
+            for(std::size_t i{0}; i < NumErrorCodes; i += 17) {
+                auto const a = map.get(ErrorCode(i));
+                auto const b = sorted.get(ErrorCode(i));
+                REQUIRE_THAT((std::string{a.begin(), a.end()}), Equals(std::string{b.begin(), b.end()}));
+            }
+        }
+    }
+
+    GIVEN("A StringMap with a repeated key and a perfect hash lookup") {
+        auto const map = StringMap<unsigned, NilEncoder, PerfectHashLookup>([] {
+            return std::to_array<KeyedStringView<unsigned>>({ {7, "first"}, {3, "three"}, {7, "second"} });
+        });
+
+        THEN("The first string for the key should be found") {
+            REQUIRE(map.get(7) == "first");
+            REQUIRE(map.get(3) == "three");
+            REQUIRE_FALSE(map.contains(4));
+        }
+    }
+}
+
+
+SCENARIO("StringMap<DenseLookup> can find strings", "[StringMap][DenseLookup]")
+{
+    GIVEN("A StringMap with enum keys and a dense lookup") {
+        auto const map = StringMap<Key, HuffmanEncoder, DenseLookup>(buildMapStrings);
+
+        THEN("It should use direct indexing") {
+            using Lookup = std::remove_cvref_t<decltype(map)>::LookupType;
+            REQUIRE(std::tuple_size_v<decltype(Lookup::m_Indices)> == 3);
+        }
+
+        THEN("The present keys should be found") {
+            REQUIRE(map.contains(Key::String_1));
+            REQUIRE(map.contains(Key::String_3));
+
+            auto const s = map.get(Key::String_3);
+            REQUIRE_THAT((std::string{s.begin(), s.end()}), Equals("Third String"));
+        }
+
+        THEN("The missing key should not be found") {
+            REQUIRE_FALSE(map.contains(Key::String_2));
+            REQUIRE(map.get(Key::String_2).size() == 0);
+        }
+    }
+
+    GIVEN("A StringMap of negative integer keys and a dense lookup") {
+        auto const map = StringMap<int, NilEncoder, DenseLookup>([] {
+            return std::to_array<KeyedStringView<int>>({ {-2, "minus two"}, {1, "one"}, {-1, "minus one"}, {1, "again"} });
+        });
+
+        THEN("Every key should give its first string") {
+            REQUIRE(map.get(-2) == "minus two");
+            REQUIRE(map.get(-1) == "minus one");
+            REQUIRE(map.get(1) == "one");
+        }
+
+        THEN("Keys inside and outside the range should not be found") {
+            REQUIRE_FALSE(map.contains(0));
+            REQUIRE_FALSE(map.contains(-3));
+            REQUIRE_FALSE(map.contains(2));
+            REQUIRE_FALSE(map.contains(std::numeric_limits<int>::min()));
+            REQUIRE_FALSE(map.contains(std::numeric_limits<int>::max()));
+        }
+    }
+
+    GIVEN("A StringMap of sparse integer keys and a dense lookup") {
+        auto const map = StringMap<int, HuffmanEncoder, DenseLookup>(buildErrorStrings);
+        auto const sorted = StringMap<int, HuffmanEncoder, SortedLookup>(buildErrorStrings);
+
+        THEN("It should fall back to a sorted lookup") {
+            REQUIRE(std::is_same_v<decltype(map), decltype(sorted)>);
+            auto const s = map.get(ErrorCode(42));
+            REQUIRE_THAT((std::string{s.begin(), s.end()}), Equals(std::string{Messages.at(42 % Messages.size())}));
+        }
+    }
+
+    GIVEN("A StringMap with the default lookup") {
+        auto const map = StringMap<Key>(buildMapStrings);
+
+        THEN("It should use the dense lookup") {
+            using Dense = decltype(StringMap<Key, HuffmanEncoder, DenseLookup>(buildMapStrings));
+            REQUIRE(std::is_same_v<std::remove_cvref_t<decltype(map)>, Dense>);
+        }
+    }
+}
+
+
+SCENARIO("StringMap<EytzingerLookup> can find strings", "[StringMap][EytzingerLookup]")
+{
+    GIVEN("A StringMap with enum keys and an Eytzinger lookup") {
+        auto const map = StringMap<Key, HuffmanEncoder, EytzingerLookup>(buildMapStrings);
+
+        THEN("The present keys should be found") {
+            REQUIRE(map.contains(Key::String_1));
+            REQUIRE(map.contains(Key::String_3));
+
+            auto const s = map.get(Key::String_1);
+            REQUIRE_THAT((std::string{s.begin(), s.end()}), Equals("First String"));
+        }
+
+        THEN("The missing key should not be found") {
+            REQUIRE_FALSE(map.contains(Key::String_2));
+        }
+    }
+
+    GIVEN("A StringMap of many sparse integer keys and an Eytzinger lookup") {
+        auto const map = StringMap<int, HuffmanEncoder, EytzingerLookup>(buildErrorStrings);
+
+        THEN("Every key should give its string") {
+            for(std::size_t i{0}; i < NumErrorCodes; ++i) {
+                auto const s = map.get(ErrorCode(i));
+                REQUIRE_THAT((std::string{s.begin(), s.end()}), Equals(std::string{Messages.at(i % Messages.size())}));
+            }
+        }
+
+        THEN("Keys between, below and above the codes should not be found") {
+            for(std::size_t i{0}; i < NumErrorCodes; ++i) {
+                REQUIRE_FALSE(map.contains(ErrorCode(i) + 1));
+            }
+            REQUIRE_FALSE(map.contains(ErrorCode(0) - 1));
+            REQUIRE_FALSE(map.contains(std::numeric_limits<int>::max()));
+        }
+    }
+
+    GIVEN("A StringMap with enough sparse keys to prefetch") {
+        static constexpr std::size_t NumKeys = 3000;
+        auto const map = StringMap<std::uint32_t, NilEncoder, EytzingerLookup>([] {
+            std::array<KeyedStringView<std::uint32_t>, NumKeys> result{};
+            for(std::size_t i{0}; i < result.size(); ++i) {
+                result.at(i) = {static_cast<std::uint32_t>(i * 7919 + 3), Messages.at(i % Messages.size())};
+            }
+            return result;
+        });
+
+        THEN("It should prefetch") {
+            using Lookup = std::remove_cvref_t<decltype(map)>::LookupType;
+            REQUIRE(Lookup::UsePrefetch);
+        }
+
+        THEN("Every key should give its string, and no others") {
+            for(std::size_t i{0}; i < NumKeys; ++i) {
+                auto const key = static_cast<std::uint32_t>(i * 7919 + 3);
+                REQUIRE(map.get(key) == Messages.at(i % Messages.size()));
+                REQUIRE_FALSE(map.contains(key + 1));
+            }
+            REQUIRE_FALSE(map.contains(0));
+        }
+    }
+
+    GIVEN("A StringMap with a repeated key and an Eytzinger lookup") {
+        auto const map = StringMap<unsigned, NilEncoder, EytzingerLookup>([] {
+            return std::to_array<KeyedStringView<unsigned>>({ {7, "first"}, {3, "three"}, {7, "second"} });
+        });
+
+        THEN("The first string for the key should be found") {
+            REQUIRE(map.get(7) == "first");
+            REQUIRE(map.get(3) == "three");
+        }
+    }
+}
+
+
+SCENARIO("StringMap can find a key once and use the result", "[StringMap]")
+{
+    GIVEN("A StringMap") {
+        auto const map = StringMap<Key>(buildMapStrings);
+
+        THEN("find() should give a handle to get the string") {
+            auto const found = map.find(Key::String_3);
+            REQUIRE(found);
+
+            auto const s = map.get(found);
+            REQUIRE_THAT((std::string{s.begin(), s.end()}), Equals("Third String"));
+        }
+
+        THEN("find() should give an empty handle for a missing key") {
+            auto const found = map.find(Key::String_2);
+            REQUIRE_FALSE(found);
+            REQUIRE(map.get(found).size() == 0);
+        }
+
+        THEN("try_get() should give the string for a present key") {
+            auto const s = map.try_get(Key::String_1);
+            REQUIRE(s.has_value());
+            REQUIRE_THAT((std::string{s->begin(), s->end()}), Equals("First String"));
+        }
+
+        THEN("try_get() should give nothing for a missing key") {
+            REQUIRE_FALSE(map.try_get(Key::String_2).has_value());
+        }
+    }
+}
+
+
+SCENARIO("StringMap<PackedLookup> can find strings", "[StringMap][PackedLookup]")
+{
+    GIVEN("A StringMap with enum keys and a packed lookup") {
+        auto const map = StringMap<Key, HuffmanEncoder, PackedLookup>(buildMapStrings);
+
+        THEN("The present keys should be found") {
+            auto const s1 = map.get(Key::String_1);
+            REQUIRE_THAT((std::string{s1.begin(), s1.end()}), Equals("First String"));
+
+            auto const s3 = map.get(Key::String_3);
+            REQUIRE_THAT((std::string{s3.begin(), s3.end()}), Equals("Third String"));
+        }
+
+        THEN("The missing key should not be found") {
+            REQUIRE_FALSE(map.contains(Key::String_2));
+        }
+    }
+
+    GIVEN("A StringMap of many sparse integer keys and a packed lookup") {
+        auto const map = StringMap<int, HuffmanEncoder, PackedLookup>(buildErrorStrings);
+
+        THEN("Every key should give its string") {
+            for(std::size_t i{0}; i < NumErrorCodes; ++i) {
+                auto const s = map.get(ErrorCode(i));
+                REQUIRE_THAT((std::string{s.begin(), s.end()}), Equals(std::string{Messages.at(i % Messages.size())}));
+            }
+        }
+
+        THEN("Keys between, below and above the codes should not be found") {
+            for(std::size_t i{0}; i < NumErrorCodes; ++i) {
+                REQUIRE_FALSE(map.contains(ErrorCode(i) + 1));
+            }
+            REQUIRE_FALSE(map.contains(ErrorCode(0) - 1));
+            REQUIRE_FALSE(map.contains(std::numeric_limits<int>::min()));
+            REQUIRE_FALSE(map.contains(std::numeric_limits<int>::max()));
+        }
+
+        THEN("The lookup should be less than half the size of a sorted lookup") {
+            using Packed = std::remove_cvref_t<decltype(map)>::LookupType;
+            using Sorted = std::remove_cvref_t<decltype(StringMap<int, HuffmanEncoder, SortedLookup>(buildErrorStrings))>::LookupType;
+            REQUIRE(sizeof(Packed) * 2 < sizeof(Sorted));
+        }
+    }
+
+    GIVEN("A StringMap with a repeated key and a packed lookup") {
+        auto const map = StringMap<unsigned, NilEncoder, PackedLookup>([] {
+            return std::to_array<KeyedStringView<unsigned>>({ {7, "first"}, {3, "three"}, {7, "second"} });
+        });
+
+        THEN("The first string for the key should be found") {
+            REQUIRE(map.get(7) == "first");
+            REQUIRE(map.get(3) == "three");
+            REQUIRE_FALSE(map.contains(5));
+        }
+    }
+
+    GIVEN("A StringMap with string keys and a packed lookup") {
+        auto const map = StringMap<std::string_view, NilEncoder, PackedLookup>([] {
+            return std::to_array<KeyedStringView<std::string_view>>({ {"b", "bee"}, {"a", "ay"} });
+        });
+
+        THEN("It should fall back to a sorted lookup over the sorted strings") {
+            REQUIRE(map.get("a") == "ay");
+            REQUIRE(map.get("b") == "bee");
+            REQUIRE_FALSE(map.contains("c"));
+        }
+    }
+}
+
+
+static auto buildCommandStrings = [] {
+    return std::to_array<KeyedStringView<std::string_view>>({
+        {"help", "help [command] - show the usage of a command"},
+        {"set", "set <name> <value> - change a setting"},
+        {"get", "get <name> - show a setting"},
+        {"reset", "reset - restore the default settings"},
+        {"reboot", "reboot - restart the device"},
+    });
+};
+
+
+SCENARIO("StringMap can be keyed by strings", "[StringMap][PerfectHashLookup]")
+{
+    GIVEN("A StringMap with string keys and a perfect hash lookup") {
+        auto const map = StringMap<std::string_view, HuffmanEncoder, PerfectHashLookup>(buildCommandStrings);
+
+        THEN("The keys should be stored with the encoder") {
+            using Lookup = std::remove_cvref_t<decltype(map)>::LookupType;
+            REQUIRE(Lookup::IsStringKey);
+        }
+
+        THEN("Every key should give its string") {
+            for(auto const &e : buildCommandStrings()) {
+                auto const s = map.get(e.Key);
+                REQUIRE_THAT((std::string{s.begin(), s.end()}), Equals(std::string{e.Value}));
+            }
+        }
+
+        THEN("Keys from runtime input should be found") {
+            std::string const input{"reboot"};
+            REQUIRE(map.contains(input));
+        }
+
+        THEN("Other strings should not be found") {
+            REQUIRE_FALSE(map.contains(""));
+            REQUIRE_FALSE(map.contains("hel"));
+            REQUIRE_FALSE(map.contains("helpme"));
+            REQUIRE_FALSE(map.contains("Help"));
+            REQUIRE_FALSE(map.try_get("unknown").has_value());
+        }
+    }
+
+    GIVEN("A StringMap with string keys and the default lookup") {
+        auto const map = StringMap<std::string_view, NilEncoder>(buildCommandStrings);
+
+        THEN("Keys should be found") {
+            REQUIRE(map.get("set") == "set <name> <value> - change a setting");
+            REQUIRE_FALSE(map.contains("unset"));
+        }
+    }
+
+    GIVEN("A StringMap with string keys and an Eytzinger lookup") {
+        auto const map = StringMap<std::string_view, NilEncoder, EytzingerLookup>(buildCommandStrings);
+
+        THEN("Keys should be found") {
+            REQUIRE(map.get("reset") == "reset - restore the default settings");
+            REQUIRE_FALSE(map.contains("zzz"));
+        }
+    }
+}
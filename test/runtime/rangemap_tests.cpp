@@ -0,0 +1,76 @@
+#include <catch2/catch.hpp>
+#include <string>
+#include <limits>
+
+#include <squeeze/squeeze.h>
+
+using Catch::Matchers::Equals;
+using namespace squeeze;
+
+static auto buildRangeStrings = [] {
+    return std::to_array<KeyedRangeStringView<unsigned>>({
+        // out of order, with gaps between some ranges
+        {0x8000, 0x80FF, "Vendor error"},
+        {0x0000, 0x0000, "Success"},
+        {0x0001, 0x00FF, "General error"},
+        {0x0200, 0x02FF, "Configuration error"},
+        {0xFF00, std::numeric_limits<unsigned>::max(), "Reserved"},
+    });
+};
+
+static std::string ToString(auto const &s)
+{
+    return std::string{s.begin(), s.end()};
+}
+
+
+SCENARIO("StringRangeMap can find the string for any key in a range", "[StringRangeMap]")
+{
+    GIVEN("A StringRangeMap") {
+        auto const map = StringRangeMap<unsigned>(buildRangeStrings);
+
+        THEN("The number of strings should be the number of ranges") {
+            REQUIRE(map.count() == 5);
+        }
+
+        THEN("Keys at both ends and inside a range should give its string") {
+            REQUIRE_THAT(ToString(map.get(0x8000)), Equals("Vendor error"));
+            REQUIRE_THAT(ToString(map.get(0x8042)), Equals("Vendor error"));
+            REQUIRE_THAT(ToString(map.get(0x80FF)), Equals("Vendor error"));
+            REQUIRE_THAT(ToString(map.get(0x0000)), Equals("Success"));
+            REQUIRE_THAT(ToString(map.get(0x0001)), Equals("General error"));
+            REQUIRE_THAT(ToString(map.get(0x0250)), Equals("Configuration error"));
+            REQUIRE_THAT(ToString(map.get(std::numeric_limits<unsigned>::max())), Equals("Reserved"));
+        }
+
+        THEN("Keys between ranges should not be found") {
+            REQUIRE_FALSE(map.contains(0x0100));
+            REQUIRE_FALSE(map.contains(0x01FF));
+            REQUIRE_FALSE(map.contains(0x0300));
+            REQUIRE_FALSE(map.contains(0x8100));
+            REQUIRE(map.get(0x7FFF).size() == 0);
+            REQUIRE_FALSE(map.try_get(0xFEFF).has_value());
+        }
+    }
+
+    GIVEN("A StringRangeMap with signed keys and the NilEncoder") {
+        auto const map = StringRangeMap<int, NilEncoder>([] {
+            return std::to_array<KeyedRangeStringView<int>>({
+                {-100, -1, "Negative"},
+                {1, 100, "Positive"},
+            });
+        });
+
+        THEN("Keys should be found in the right range") {
+            REQUIRE(map.get(-100) == "Negative");
+            REQUIRE(map.get(-1) == "Negative");
+            REQUIRE(map.get(50) == "Positive");
+        }
+
+        THEN("Keys outside the ranges should not be found") {
+            REQUIRE_FALSE(map.contains(-101));
+            REQUIRE_FALSE(map.contains(0));
+            REQUIRE_FALSE(map.contains(101));
+        }
+    }
+}
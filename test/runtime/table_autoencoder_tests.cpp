@@ -0,0 +1,115 @@
+#include <catch2/catch.hpp>
+
+#include <squeeze/squeeze.h>
+
+using namespace squeeze;
+
+static auto buildTinyStrings = [] {
+    return std::to_array<std::string_view> ({
+        "ok",
+        "error",
+    });
+};
+
+static auto buildTableStrings = [] {
+    return std::to_array<std::string_view> ({
+        "failed to open connection: timeout",
+        "failed to close connection: timeout",
+        "failed to read from connection",
+        "failed to write to connection",
+        "",
+        "connection reset by peer",
+        "timeout waiting for connection",
+        "connection refused by peer",
+    });
+};
+
+// UTF-8, so the strings have bytes from 0x80 up
+static auto buildNonAsciiStrings = [] {
+    return std::to_array<std::string_view> ({
+        "na\xc3\xafve caf\xc3\xa9",
+        "cr\xc3\xa8me br\xc3\xbbl\xc3\xa9",
+        "\xe2\x82\xac 10",
+    });
+};
+
+static auto buildEmptyStrings = [] {
+    return std::to_array<std::string_view> ({
+        "",
+        "",
+    });
+};
+
+SCENARIO("StringTable<AutoEncoder> picks the smallest encoder", "[StringTable][AutoEncoder]")
+{
+    GIVEN("A StringTable of a few short strings") {
+        auto const table = StringTable<AutoEncoder<>>(buildTinyStrings);
+
+        THEN("The strings should be stored as they are") {
+            STATIC_REQUIRE(std::is_same_v<decltype(table), decltype(StringTable<NilEncoder>(buildTinyStrings)) const>);
+        }
+    }
+
+    GIVEN("A StringTable of repetitive strings") {
+        auto const table = StringTable<AutoEncoder<>>(buildTableStrings);
+
+        THEN("No candidate encoder should be smaller") {
+            REQUIRE(sizeof(table) <= sizeof(StringTable<NilEncoder>(buildTableStrings)));
+            REQUIRE(sizeof(table) <= sizeof(StringTable<HuffmanEncoder>(buildTableStrings)));
+            REQUIRE(sizeof(table) <= sizeof(StringTable<LzEncoder>(buildTableStrings)));
+            REQUIRE(sizeof(table) <= sizeof(StringTable<TokenEncoder>(buildTableStrings)));
+            REQUIRE(sizeof(table) <= sizeof(StringTable<FsstEncoder>(buildTableStrings)));
+        }
+    }
+
+    GIVEN("A StringTable of non-ASCII strings") {
+        auto const table = StringTable<AutoEncoder<>>(buildNonAsciiStrings);
+
+        THEN("The Huffman and tANS candidates should be compiled and compared") {
+            REQUIRE(sizeof(table) <= sizeof(StringTable<HuffmanEncoder>(buildNonAsciiStrings)));
+            REQUIRE(sizeof(table) <= sizeof(StringTable<CanonicalHuffmanEncoder>(buildNonAsciiStrings)));
+            REQUIRE(sizeof(table) <= sizeof(StringTable<TansEncoder>(buildNonAsciiStrings)));
+        }
+    }
+
+    GIVEN("A StringTable of only empty strings") {
+        auto const table = StringTable<AutoEncoder<>>(buildEmptyStrings);
+
+        THEN("The Huffman and tANS candidates should be compiled and compared") {
+            REQUIRE(sizeof(table) <= sizeof(StringTable<HuffmanEncoder>(buildEmptyStrings)));
+            REQUIRE(sizeof(table) <= sizeof(StringTable<CanonicalHuffmanEncoder>(buildEmptyStrings)));
+            REQUIRE(sizeof(table) <= sizeof(StringTable<TansEncoder>(buildEmptyStrings)));
+        }
+    }
+}
+
+
+SCENARIO("StringTable<AutoEncoder> can pick the fastest encoder that compresses", "[StringTable][AutoEncoder]")
+{
+    GIVEN("A StringTable for speed of a few short strings") {
+        auto const table = StringTable<AutoEncoder<autoselect::Objective::Speed>>(buildTinyStrings);
+
+        THEN("The strings should be stored as they are") {
+            STATIC_REQUIRE(std::is_same_v<decltype(table), decltype(StringTable<NilEncoder>(buildTinyStrings)) const>);
+        }
+    }
+
+    GIVEN("A StringTable for speed of repetitive strings") {
+        auto const table = StringTable<AutoEncoder<autoselect::Objective::Speed>>(buildTableStrings);
+
+        THEN("The strings should be compressed") {
+            REQUIRE(sizeof(table) < sizeof(StringTable<NilEncoder>(buildTableStrings)));
+        }
+    }
+
+    GIVEN("A choice of encoders") {
+        constexpr std::array<std::size_t, 3> sizes{100, 60, 80};
+        constexpr std::array<std::size_t, 3> costs{1, 10, 5};
+
+        THEN("The objective decides which is kept") {
+            STATIC_REQUIRE(autoselect::Choose(autoselect::Objective::Size, sizes, costs) == 1);
+            STATIC_REQUIRE(autoselect::Choose(autoselect::Objective::Speed, sizes, costs) == 2);
+        }
+    }
+}
+
@@ -0,0 +1,98 @@
+#include <catch2/catch.hpp>
+#include <string>
+
+#include <squeeze/squeeze.h>
+
+using namespace squeeze;
+using Catch::Matchers::Equals;
+
+using SingleClassContextHuffmanEncoder = BasicContextHuffmanEncoder<context::Options{.ContextClasses = 1}>;
+
+static auto buildTableStrings = [] {
+    return std::to_array<std::string_view> ({
+        "failed to open connection: timeout",
+        "failed to close connection: timeout",
+        "failed to read from connection",
+        "failed to write to connection",
+        "connection reset by peer",
+        "timeout waiting for connection",
+        "connection refused by peer",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+    });
+};
+
+// each character is always followed by the same one, but all four are equally common
+static constexpr auto CyclicText = [] {
+    std::array<char, 4000> text{};
+    for(std::size_t i{0}; i < text.size(); ++i) {
+        text.at(i) = "abcd"[i % 4];
+    }
+    return text;
+}();
+
+static auto buildCyclicStrings = [] {
+    return std::to_array<std::string_view> ({
+        std::string_view{CyclicText.data(), 2000},
+        // not a copy or suffix of the first, so the Huffman table can't share it
+        std::string_view{CyclicText.data() + 2000, 1998},
+    });
+};
+
+static std::string ToString(auto const &s)
+{
+    return std::string{s.begin(), s.end()};
+}
+
+
+SCENARIO("StringTable<ContextHuffmanEncoder> codes characters by what comes before", "[StringTable][ContextHuffmanEncoder]")
+{
+    GIVEN("A StringTable with ContextHuffmanEncoder") {
+        auto const table = StringTable<ContextHuffmanEncoder>(buildTableStrings);
+
+        THEN("The table and its codes should be smaller than the strings") {
+            REQUIRE(sizeof(table) < sizeof(StringTable<NilEncoder>(buildTableStrings)));
+        }
+    }
+
+    GIVEN("A StringTable with one context class") {
+        using Encoding = decltype(SingleClassContextHuffmanEncoder::Compile(buildTableStrings));
+        using Canonical = decltype(CanonicalHuffmanEncoder::Compile(buildTableStrings));
+
+        THEN("Every character should be coded as CanonicalHuffmanEncoder codes it") {
+            // no string is a copy or suffix of another, so CanonicalHuffmanEncoder can't share any
+            STATIC_REQUIRE(Encoding::ClassBits == 0);
+            STATIC_REQUIRE(Encoding::NumEncodedBits == Canonical::NumEncodedBits);
+        }
+    }
+
+    GIVEN("A StringTable of strings where each character predicts the next") {
+        auto const table = StringTable<ContextHuffmanEncoder>(buildCyclicStrings);
+
+        THEN("Every string should be decoded") {
+            REQUIRE_THAT(ToString(table[0]), Equals(std::string{buildCyclicStrings().at(0)}));
+            REQUIRE_THAT(ToString(table[1]), Equals(std::string{buildCyclicStrings().at(1)}));
+        }
+
+        THEN("Each character should be its own class") {
+            static constexpr auto encoding = ContextHuffmanEncoder::Compile(buildCyclicStrings);
+            auto const classOf = [](char c) { return encoding.class_of(c); };
+
+            REQUIRE(classOf('a') != classOf('b'));
+            REQUIRE(classOf('a') != classOf('c'));
+            REQUIRE(classOf('a') != classOf('d'));
+            REQUIRE(classOf('b') != classOf('c'));
+            REQUIRE(classOf('b') != classOf('d'));
+            REQUIRE(classOf('c') != classOf('d'));
+        }
+
+        THEN("Each character should be coded in a single bit") {
+            using Encoding = decltype(ContextHuffmanEncoder::Compile(buildCyclicStrings));
+            STATIC_REQUIRE(Encoding::NumEncodedBits == 2000 + 1998);
+        }
+
+        THEN("Characters should be coded in fewer bits than without context") {
+            auto const huffman = StringTable<CanonicalHuffmanEncoder>(buildCyclicStrings);
+            REQUIRE(sizeof(table) < sizeof(huffman));
+        }
+    }
+}
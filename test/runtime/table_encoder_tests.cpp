@@ -0,0 +1,131 @@
+#include <catch2/catch.hpp>
+#include <string>
+#include <tuple>
+
+#include <squeeze/squeeze.h>
+
+using namespace squeeze;
+using Catch::Matchers::Equals;
+
+//
+// Round trip checks every encoder should pass. Checks particular to an encoder are in its own file.
+//
+
+using SmallWindowLzEncoder = BasicLzEncoder<lz::Options{.WindowSize = 8, .MinMatch = 2, .MaxMatch = 5}>;
+
+using ShortTokenEncoder = BasicTokenEncoder<token::Options{.MaxTokens = 4, .MaxTokenLength = 2}>;
+
+using LargeTableTansEncoder = BasicTansEncoder<tans::Options{.TableLog = 11}>;
+
+using SingleClassContextHuffmanEncoder = BasicContextHuffmanEncoder<context::Options{.ContextClasses = 1}>;
+
+using LookupHybridEncoder = BasicHybridEncoder<hybrid::Options{.MaxCodeLength = 10, .LookupBits = 6}>;
+
+using Encoders = std::tuple<
+    LzEncoder,
+    HuffmanLzEncoder,
+    SmallWindowLzEncoder,
+    TokenEncoder,
+    ShortTokenEncoder,
+    FsstEncoder,
+    TansEncoder,
+    LargeTableTansEncoder,
+    ContextHuffmanEncoder,
+    SingleClassContextHuffmanEncoder,
+    HybridEncoder,
+    LookupHybridEncoder,
+    AutoEncoder<>,
+    AutoEncoder<autoselect::Objective::Speed>>;
+
+static auto buildTableStrings = [] {
+    return std::to_array<std::string_view> ({
+        "failed to open connection: timeout",
+        "failed to close connection: timeout",
+        "failed to read from connection",
+        "failed to write to connection",
+        "",
+        "connection reset by peer",
+        "timeout waiting for connection",
+        "connection refused by peer",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "x",
+        "na\xc3\xafve caf\xc3\xa9",    // UTF-8, so it has bytes from 0x80 up
+    });
+};
+
+static auto buildEmptyStrings = [] {
+    return std::to_array<std::string_view> ({
+        "",
+        "",
+    });
+};
+
+static std::string ToString(auto const &s)
+{
+    return std::string{s.begin(), s.end()};
+}
+
+
+TEMPLATE_LIST_TEST_CASE("StringTable gives back every string with each encoder", "[StringTable]", Encoders)
+{
+    auto const table = StringTable<TestType>(buildTableStrings);
+    auto const expected = buildTableStrings();
+
+    SECTION("Every string should be iterated") {
+        REQUIRE(table.count() == expected.size());
+        for(std::size_t i{0}; i < expected.size(); ++i) {
+            REQUIRE(table[i].size() == expected.at(i).size());
+            REQUIRE_THAT(ToString(table[i]), Equals(std::string{expected.at(i)}));
+        }
+    }
+
+    SECTION("Every string should be copied in bulk") {
+        for(std::size_t i{0}; i < expected.size(); ++i) {
+            std::string copy;
+            REQUIRE(table.copy_to(i, std::back_inserter(copy)) == expected.at(i).size());
+            REQUIRE_THAT(copy, Equals(std::string{expected.at(i)}));
+
+            std::array<char, 128> buffer{};
+            REQUIRE(table.decode_into(i, buffer) == expected.at(i).size());
+            REQUIRE_THAT((std::string{buffer.data(), expected.at(i).size()}), Equals(std::string{expected.at(i)}));
+        }
+    }
+
+    SECTION("Decoding into a small buffer should stop when it is full") {
+        std::array<char, 16> buffer{};
+        REQUIRE(table.decode_into(0, buffer) == buffer.size());
+        REQUIRE_THAT((std::string{buffer.begin(), buffer.end()}), Equals("failed to open c"));
+    }
+
+    SECTION("An index outside the table should give an empty string") {
+        REQUIRE(table[100].size() == 0);
+        REQUIRE(table[100].begin() == table[100].end());
+    }
+}
+
+
+TEMPLATE_LIST_TEST_CASE("StringTable of only empty strings compiles with each encoder", "[StringTable]", Encoders)
+{
+    auto const table = StringTable<TestType>(buildEmptyStrings);
+
+    REQUIRE(table.count() == 2);
+    REQUIRE(table[0].size() == 0);
+    REQUIRE(table[1].begin() == table[1].end());
+}
+
+
+TEMPLATE_LIST_TEST_CASE("StringMap finds every string with each encoder", "[StringMap]", Encoders)
+{
+    auto const map = StringMap<int, TestType>([] {
+        return std::to_array<KeyedStringView<int>>({
+            {404, "resource not found"},
+            {410, "resource gone"},
+            {503, "service unavailable"},
+        });
+    });
+
+    REQUIRE_THAT(ToString(map.get(410)), Equals("resource gone"));
+    REQUIRE_THAT(ToString(map.get(404)), Equals("resource not found"));
+    REQUIRE_THAT(ToString(map.get(503)), Equals("service unavailable"));
+    REQUIRE_FALSE(map.contains(500));
+}
@@ -0,0 +1,134 @@
+#include <catch2/catch.hpp>
+#include <string>
+
+#include <squeeze/squeeze.h>
+
+using namespace squeeze;
+using Catch::Matchers::Equals;
+
+static auto buildTableStrings = [] {
+    return std::to_array<std::string_view> ({
+        "failed to open connection: timeout",
+        "failed to close connection: timeout",
+        "failed to read from connection",
+        "failed to write to connection",
+        "",
+        "connection reset by peer",
+        "timeout waiting for connection",
+        "connection refused by peer",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "x",
+    });
+};
+
+// the same few phrases in many strings
+static auto buildRepeatedStrings = [] {
+    return std::to_array<std::string_view> ({
+        "failed to open connection: timeout",
+        "failed to close connection: timeout",
+        "failed to read from connection: timeout",
+        "failed to write to connection: timeout",
+        "failed to open connection: refused",
+        "failed to close connection: refused",
+        "failed to read from connection: refused",
+        "failed to write to connection: refused",
+        "connection reset by peer",
+        "connection refused by peer",
+        "timeout waiting for connection",
+    });
+};
+
+static std::string ToString(auto const &s)
+{
+    return std::string{s.begin(), s.end()};
+}
+
+
+SCENARIO("StringTable<FsstEncoder> stores repeated phrases as symbols", "[StringTable][FsstEncoder]")
+{
+    GIVEN("A StringTable with FsstEncoder of repeated phrases") {
+        auto const table = StringTable<FsstEncoder>(buildRepeatedStrings);
+
+        THEN("Repeated phrases should be stored as symbols") {
+            REQUIRE(sizeof(table) < sizeof(StringTable<NilEncoder>(buildRepeatedStrings)));
+        }
+    }
+
+    GIVEN("A symbol table encoding decoded into buffers with room to spare") {
+        static constexpr auto encoding = fsst::MakeEncoding(buildTableStrings);
+        auto const expected = buildTableStrings();
+
+        THEN("Nothing past the decoded characters should be written") {
+            for(std::size_t i{0}; i < expected.size(); ++i) {
+                std::array<char, 128> buffer{};
+                buffer.fill('#');
+                REQUIRE(encoding[i].decode_into(buffer) == expected.at(i).size());
+                REQUIRE_THAT((std::string{buffer.data(), expected.at(i).size()}), Equals(std::string{expected.at(i)}));
+                REQUIRE(std::all_of(buffer.begin() + static_cast<std::ptrdiff_t>(expected.at(i).size()), buffer.end(), [](char c) { return c == '#'; }));
+            }
+        }
+    }
+
+    GIVEN("An encoding with few symbols") {
+        // too few symbols to beat NilEncoder, so build the encoding directly rather than let the encoder fall back
+        static constexpr auto encoding = fsst::MakeEncoding<fsst::Options{.MaxSymbols = 4, .Rounds = 2}>(buildTableStrings);
+
+        THEN("Every string should be decoded") {
+            auto const expected = buildTableStrings();
+            for(std::size_t i{0}; i < expected.size(); ++i) {
+                REQUIRE_THAT(ToString(encoding[i]), Equals(std::string{expected.at(i)}));
+            }
+        }
+    }
+}
+
+
+SCENARIO("StringTable<FsstEncoder> only stores symbols that pay for themselves", "[StringTable][FsstEncoder]")
+{
+    // a few lines of English, with little repeated
+    static constexpr auto makeLines = [] {
+        return std::to_array<std::string_view>({
+            "The quick brown fox jumps over the lazy dog near the river bank.",
+            "A journey of a thousand miles begins with a single step.",
+            "Please check your network settings and try again later.",
+            "Every morning she walked along the beach collecting shells.",
+            "Nothing is certain except death and taxes.",
+            "The meeting has been moved to Thursday afternoon at three o'clock.",
+            "Keep calm and carry on.",
+            "Bright stars filled the cold winter sky above the quiet village below.",
+            "He forgot his umbrella, so he got soaked on the way home.",
+            "Music gives a soul to the universe and wings to the mind.",
+        });
+    };
+
+    GIVEN("A symbol table built for text with little repeated") {
+        static constexpr auto encoding = fsst::MakeEncoding(makeLines);
+
+        THEN("Symbols used only a few times should be escaped instead") {
+            STATIC_REQUIRE(encoding.m_SymbolLengths.size() < 32);
+        }
+
+        THEN("Every string should be decoded") {
+            auto const expected = makeLines();
+            for(std::size_t i{0}; i < expected.size(); ++i) {
+                REQUIRE_THAT(ToString(encoding[i]), Equals(std::string{expected.at(i)}));
+            }
+        }
+    }
+
+    GIVEN("A StringTable with FsstEncoder of the same text") {
+        auto const table = StringTable<FsstEncoder>(makeLines);
+        auto const nil = StringTable<NilEncoder>(makeLines);
+
+        THEN("The table should be no larger than NilEncoder") {
+            REQUIRE(sizeof(table) <= sizeof(nil));
+        }
+
+        THEN("Every string should be decoded") {
+            auto const expected = makeLines();
+            for(std::size_t i{0}; i < expected.size(); ++i) {
+                REQUIRE_THAT(ToString(table[i]), Equals(std::string{expected.at(i)}));
+            }
+        }
+    }
+}
@@ -177,3 +177,599 @@ SCENARIO("StringTable<HuffmanEncoder> can provide correct strings", "[StringTabl
         }
     }
 }
+
+SCENARIO("StringTable<TableHuffmanEncoder> can provide correct strings", "[StringTable][HuffmanEncoder]") {
+    GIVEN("A runtime initialised StringTable<TableHuffmanEncoder>"){
+        auto const table = StringTable<TableHuffmanEncoder>(buildTableStrings);
+
+        THEN("All strings should match the source data") {
+            auto sourceTable = buildTableStrings();
+            for(std::size_t i{0}; i < sourceTable.size(); ++i) {
+                auto s = table[i];
+                auto expected = std::string{sourceTable[i]};
+
+                std::string extracted{s.begin(), s.end()};
+
+                REQUIRE(s.size() == expected.size());
+                REQUIRE_THAT(extracted, Equals(expected));
+            }
+        }
+    }
+
+    GIVEN("A lookup table shorter than the longest code"){
+        // some codes will need to fall back to walking the tree after the lookup
+        auto const table = StringTable<BasicHuffmanEncoder<huffman::Options{.LookupBits = 3}>>(buildTableStrings);
+
+        THEN("All strings should match the source data") {
+            auto sourceTable = buildTableStrings();
+            for(std::size_t i{0}; i < sourceTable.size(); ++i) {
+                auto s = table[i];
+                auto expected = std::string{sourceTable[i]};
+
+                std::string extracted{s.begin(), s.end()};
+
+                REQUIRE(s.size() == expected.size());
+                REQUIRE_THAT(extracted, Equals(expected));
+            }
+        }
+    }
+}
+
+SCENARIO("StringTable<HuffmanEncoder> can provide single character strings", "[StringTable][HuffmanEncoder]") {
+    GIVEN("A table containing single character strings"){
+        auto const table = StringTable<HuffmanEncoder>([] {
+            return std::to_array<std::string_view>({ "a", "bc", "d" });
+        });
+
+        THEN("The strings should match the source data") {
+            auto s1 = table[0];
+            auto s3 = table[2];
+            REQUIRE_THAT((std::string{s1.begin(), s1.end()}), Equals("a"));
+            REQUIRE_THAT((std::string{s3.begin(), s3.end()}), Equals("d"));
+        }
+    }
+}
+
+SCENARIO("StringTable<HuffmanEncoder> can code any byte", "[StringTable][HuffmanEncoder]") {
+    GIVEN("A table of UTF-8 strings, with bytes from 0x80 up"){
+        auto const table = StringTable<HuffmanEncoder>([] {
+            return std::to_array<std::string_view>({ "na\xc3\xafve", "caf\xc3\xa9" });
+        });
+        auto const canonical = StringTable<CanonicalHuffmanEncoder>([] {
+            return std::to_array<std::string_view>({ "na\xc3\xafve", "caf\xc3\xa9" });
+        });
+
+        THEN("The strings should match the source data") {
+            REQUIRE_THAT((std::string{table[0].begin(), table[0].end()}), Equals("na\xc3\xafve"));
+            REQUIRE_THAT((std::string{table[1].begin(), table[1].end()}), Equals("caf\xc3\xa9"));
+            REQUIRE_THAT((std::string{canonical[1].begin(), canonical[1].end()}), Equals("caf\xc3\xa9"));
+        }
+    }
+
+    GIVEN("A table of only empty strings, so there is no tree"){
+        auto const table = StringTable<HuffmanEncoder>([] {
+            return std::to_array<std::string_view>({ "", "" });
+        });
+
+        THEN("The strings should be empty") {
+            REQUIRE(table[0].size() == 0);
+            REQUIRE(table[1].begin() == table[1].end());
+        }
+    }
+}
+
+SCENARIO("StringTable<HuffmanEncoder> stores a packed tree", "[StringTable][HuffmanEncoder]") {
+    GIVEN("A Huffman tree node") {
+        THEN("It should be a pair of 16 bit links") {
+            REQUIRE(sizeof(huffman::Node) == 2 * sizeof(huffman::Node::IndexType));
+        }
+
+        THEN("An unset node or link should not look like a leaf") {
+            REQUIRE_FALSE(huffman::Node{}.is_leaf());
+            REQUIRE_FALSE(huffman::Node::IsLeafLink(huffman::Node::BadIndex));
+            REQUIRE(huffman::Node::IsLeafLink(huffman::Node::LeafLink('\xFF')));
+        }
+    }
+
+    GIVEN("The tree tables for a runtime initialised StringTable<HuffmanEncoder>") {
+        auto const table = StringTable<HuffmanEncoder>(buildTableStrings);
+        using Tables = decltype(huffman::MakeEncodedBitStream(buildTableStrings))::TablesType;
+
+        THEN("Only the intermediate nodes should be stored") {
+            REQUIRE(Tables::NumIntermediateNodes == Tables::NumTreeNodes / 2);
+            REQUIRE(sizeof(Tables) < Tables::NumTreeNodes * sizeof(huffman::Node));
+        }
+
+        THEN("The strings should match the source data") {
+            auto const sourceTable = buildTableStrings();
+            auto const s = table[1];
+            REQUIRE_THAT((std::string{s.begin(), s.end()}), Equals(std::string{sourceTable[1]}));
+        }
+    }
+
+    GIVEN("A table that only uses one character, so the root of the tree is a leaf") {
+        auto const table = StringTable<HuffmanEncoder>([] {
+            return std::to_array<std::string_view>({ "aaa", "a", "aaaaa" });
+        });
+
+        THEN("The strings should match the source data") {
+            auto s1 = table[0];
+            auto s3 = table[2];
+            REQUIRE_THAT((std::string{s1.begin(), s1.end()}), Equals("aaa"));
+            REQUIRE_THAT((std::string{s3.begin(), s3.end()}), Equals("aaaaa"));
+        }
+    }
+}
+
+SCENARIO("StringTable<HuffmanEncoder> uses the narrowest entry index", "[StringTable][HuffmanEncoder]") {
+    GIVEN("A table of a few thousand encoded bits and strings under 64k characters") {
+        using Index = decltype(huffman::MakeEncodedBitStream(buildTableStrings).m_Entries);
+
+        THEN("The entry fields should be 16 bits") {
+            STATIC_REQUIRE(std::is_same_v<Index::FirstBitType, std::uint16_t>);
+            STATIC_REQUIRE(std::is_same_v<Index::LengthType, std::uint16_t>);
+            REQUIRE(sizeof(Index) == Index::NumEntries * 2 * sizeof(std::uint16_t));
+        }
+    }
+
+    GIVEN("A table of short strings") {
+        static constexpr auto makeStrings = [] { return std::to_array<std::string_view>({ "a", "bc", "d" }); };
+        using Index = decltype(huffman::MakeEncodedBitStream(makeStrings).m_Entries);
+        auto const table = StringTable<HuffmanEncoder>(makeStrings);
+
+        THEN("The entry fields should be single bytes") {
+            STATIC_REQUIRE(std::is_same_v<Index::FirstBitType, std::uint8_t>);
+            STATIC_REQUIRE(std::is_same_v<Index::LengthType, std::uint8_t>);
+        }
+
+        THEN("The strings should match the source data") {
+            auto s2 = table[1];
+            REQUIRE_THAT((std::string{s2.begin(), s2.end()}), Equals("bc"));
+        }
+    }
+}
+
+SCENARIO("StringTable<BasicHuffmanEncoder> can use an Elias-Fano entry index", "[StringTable][HuffmanEncoder]") {
+    // split the source text into many short strings, including some empty ones
+    static constexpr auto makeShortStrings = [] {
+        auto const text = buildTableStrings()[0];
+        std::array<std::string_view, 300> result{};
+        std::size_t pos{0};
+        for(std::size_t i{0}; i < result.size(); ++i) {
+            auto const length = i % 9;
+            result.at(i) = text.substr(pos, length);
+            pos += length;
+        }
+        return result;
+    };
+
+    using DenseEncoder = BasicHuffmanEncoder<huffman::Options{.LookupBits = 8}>;
+    using EliasFanoEncoder = BasicHuffmanEncoder<huffman::Options{.LookupBits = 8, .Index = huffman::IndexMode::EliasFano}>;
+
+    GIVEN("A table of many short strings") {
+        auto const table = StringTable<EliasFanoEncoder>(makeShortStrings);
+        auto const source = makeShortStrings();
+
+        THEN("All strings should match the source data") {
+            for(std::size_t i{0}; i < source.size(); ++i) {
+                auto const s = table[i];
+                REQUIRE(s.size() == source[i].size());
+                REQUIRE_THAT((std::string{s.begin(), s.end()}), Equals(std::string{source[i]}));
+            }
+        }
+
+        THEN("The index should be much smaller than the dense index") {
+            using DenseIndex = decltype(DenseEncoder::Compile(makeShortStrings).m_Entries);
+            using EliasFanoIndex = decltype(EliasFanoEncoder::Compile(makeShortStrings).m_Entries);
+            REQUIRE(sizeof(EliasFanoIndex) * 2 < sizeof(DenseIndex));
+        }
+    }
+
+    GIVEN("A table of long strings") {
+        auto const table = StringTable<EliasFanoEncoder>(buildTableStrings);
+        auto const source = buildTableStrings();
+
+        THEN("All strings should match the source data") {
+            for(std::size_t i{0}; i < source.size(); ++i) {
+                auto const s = table[i];
+                REQUIRE_THAT((std::string{s.begin(), s.end()}), Equals(std::string{source[i]}));
+            }
+        }
+    }
+}
+
+SCENARIO("StringTable<BasicHuffmanEncoder> shares the encoding of duplicate strings and suffixes", "[StringTable][HuffmanEncoder]") {
+    static constexpr auto makeStrings = [] {
+        return std::to_array<std::string_view>({
+            "error",
+            "parse error",
+            "",
+            "file not found",
+            "parse error",
+            "not found",
+            "found",
+            "a string that is long enough to be interleaved",
+            "a string that is long enough to be interleaved",
+            "be interleaved",
+        });
+    };
+    auto const source = makeStrings();
+
+    auto const checkTable = [&](auto const &table) {
+        for(std::size_t i{0}; i < source.size(); ++i) {
+            auto const s = table[i];
+            std::string copied;
+            s.copy_to(std::back_inserter(copied));
+
+            REQUIRE(s.size() == source[i].size());
+            REQUIRE_THAT((std::string{s.begin(), s.end()}), Equals(std::string{source[i]}));
+            REQUIRE_THAT(copied, Equals(std::string{source[i]}));
+        }
+    };
+
+    GIVEN("A tree decoded table") {
+        using Encoding = decltype(HuffmanEncoder::Compile(makeStrings));
+        using Unshared = decltype(BasicHuffmanEncoder<huffman::Options{.Index = huffman::IndexMode::EliasFano}>::Compile(makeStrings));
+        auto const table = StringTable<HuffmanEncoder>(makeStrings);
+
+        THEN("Every string should match the source data") {
+            checkTable(table);
+        }
+
+        THEN("Only the strings that aren't shared should be encoded") {
+            STATIC_REQUIRE(Encoding::NumEncodedBits * 2 < Unshared::NumEncodedBits);
+        }
+    }
+
+    GIVEN("A fast decoded canonical table with a lookup table") {
+        checkTable(StringTable<FastHuffmanEncoder>(makeStrings));
+    }
+
+    GIVEN("A table where long strings are interleaved, so can't hold suffixes") {
+        using Encoder = BasicHuffmanEncoder<huffman::Options{.LookupBits = 8, .InterleaveThreshold = 16, .InterleaveStreams = 2}>;
+
+        THEN("Every string should match the source data") {
+            checkTable(StringTable<Encoder>(makeStrings));
+        }
+    }
+
+    GIVEN("A table with an Elias-Fano index") {
+        THEN("Every string should match the source data") {
+            checkTable(StringTable<BasicHuffmanEncoder<huffman::Options{.Index = huffman::IndexMode::EliasFano}>>(makeStrings));
+        }
+    }
+}
+
+SCENARIO("StringTable<CanonicalHuffmanEncoder> can provide correct strings", "[StringTable][HuffmanEncoder]") {
+    GIVEN("A runtime initialised StringTable<CanonicalHuffmanEncoder>"){
+        auto const table = StringTable<CanonicalHuffmanEncoder>(buildTableStrings);
+
+        THEN("All strings should match the source data") {
+            auto sourceTable = buildTableStrings();
+            for(std::size_t i{0}; i < sourceTable.size(); ++i) {
+                auto s = table[i];
+                auto expected = std::string{sourceTable[i]};
+
+                std::string extracted{s.begin(), s.end()};
+
+                REQUIRE(s.size() == expected.size());
+                REQUIRE_THAT(extracted, Equals(expected));
+            }
+        }
+
+        THEN("The decode tables should be smaller than the tree") {
+            auto const tree = StringTable<HuffmanEncoder>(buildTableStrings);
+            REQUIRE(sizeof(table) < sizeof(tree));
+        }
+    }
+
+    GIVEN("Codes limited to fewer bits than the unlimited tree needs, with a lookup table"){
+        using Encoder = BasicHuffmanEncoder<huffman::Options{.LookupBits = 5, .MaxCodeLength = 7}>;
+        auto const table = StringTable<Encoder>(buildTableStrings);
+
+        THEN("All strings should match the source data") {
+            auto sourceTable = buildTableStrings();
+            for(std::size_t i{0}; i < sourceTable.size(); ++i) {
+                auto s = table[i];
+                auto expected = std::string{sourceTable[i]};
+
+                std::string extracted{s.begin(), s.end()};
+
+                REQUIRE(s.size() == expected.size());
+                REQUIRE_THAT(extracted, Equals(expected));
+            }
+        }
+    }
+}
+
+SCENARIO("StringTable<FastHuffmanEncoder> can provide correct strings", "[StringTable][HuffmanEncoder]") {
+    GIVEN("A runtime initialised StringTable<FastHuffmanEncoder>"){
+        auto const table = StringTable<FastHuffmanEncoder>(buildTableStrings);
+
+        THEN("All strings should match the source data") {
+            auto sourceTable = buildTableStrings();
+            for(std::size_t i{0}; i < sourceTable.size(); ++i) {
+                auto s = table[i];
+                auto expected = std::string{sourceTable[i]};
+
+                std::string extracted{s.begin(), s.end()};
+
+                REQUIRE(s.size() == expected.size());
+                REQUIRE_THAT(extracted, Equals(expected));
+            }
+        }
+
+        THEN("The layout should match the compact decoder") {
+            auto const compact = StringTable<BasicHuffmanEncoder<huffman::Options{.LookupBits = 10, .MaxCodeLength = 12}>>(buildTableStrings);
+            REQUIRE(sizeof(table) == sizeof(compact));
+        }
+    }
+
+    GIVEN("A fast decoded tree without a lookup table"){
+        auto const table = StringTable<BasicHuffmanEncoder<huffman::Options{.Decoder = huffman::DecodeMode::Fast}>>(buildTableStrings);
+
+        THEN("All strings should match the source data") {
+            auto sourceTable = buildTableStrings();
+            for(std::size_t i{0}; i < sourceTable.size(); ++i) {
+                auto s = table[i];
+                auto expected = std::string{sourceTable[i]};
+
+                std::string extracted{s.begin(), s.end()};
+
+                REQUIRE(s.size() == expected.size());
+                REQUIRE_THAT(extracted, Equals(expected));
+            }
+        }
+
+        WHEN("An invalid index is accessed") {
+            auto s4 = table[3];
+            THEN("Iterating the empty string works") {
+                auto t = std::string{s4.begin(), s4.end()};
+                REQUIRE(t.size() == 0);
+            }
+        }
+    }
+}
+
+SCENARIO("StringTable<HuffmanEncoder> can decode whole strings in bulk", "[StringTable][HuffmanEncoder]") {
+    GIVEN("A runtime initialised StringTable<HuffmanEncoder>"){
+        auto const table = StringTable<HuffmanEncoder>(buildTableStrings);
+        auto const sourceTable = buildTableStrings();
+
+        WHEN("A string is decoded into a large enough buffer") {
+            std::array<char, 2048> buffer{};
+            auto const n = table.decode_into(1, buffer);
+
+            THEN("The whole string should be written") {
+                REQUIRE(n == sourceTable[1].size());
+                REQUIRE_THAT((std::string{buffer.data(), n}), Equals(std::string{sourceTable[1]}));
+            }
+        }
+
+        WHEN("A string is decoded into a small buffer") {
+            std::array<char, 10> buffer{};
+            auto const n = table[0].decode_into(buffer);
+
+            THEN("Only the start of the string that fits should be written") {
+                REQUIRE(n == buffer.size());
+                REQUIRE_THAT((std::string{buffer.data(), n}), Equals(std::string{sourceTable[0].substr(0, 10)}));
+            }
+        }
+
+        WHEN("A string is copied to an output iterator") {
+            std::string extracted;
+            auto const n = table.copy_to(2, std::back_inserter(extracted));
+
+            THEN("The whole string should be written") {
+                REQUIRE(n == sourceTable[2].size());
+                REQUIRE_THAT(extracted, Equals(std::string{sourceTable[2]}));
+            }
+        }
+
+        WHEN("An invalid index is decoded") {
+            std::array<char, 10> buffer{};
+
+            THEN("Nothing should be written") {
+                REQUIRE(table.decode_into(3, buffer) == 0);
+            }
+        }
+    }
+
+    GIVEN("A runtime initialised StringTable<FastHuffmanEncoder>"){
+        auto const table = StringTable<FastHuffmanEncoder>(buildTableStrings);
+        auto const sourceTable = buildTableStrings();
+
+        THEN("Each string should decode in bulk") {
+            for(std::size_t i{0}; i < sourceTable.size(); ++i) {
+                std::string extracted;
+                REQUIRE(table.copy_to(i, std::back_inserter(extracted)) == sourceTable[i].size());
+                REQUIRE_THAT(extracted, Equals(std::string{sourceTable[i]}));
+            }
+        }
+    }
+}
+
+SCENARIO("StringTable<BasicHuffmanEncoder> can interleave long strings", "[StringTable][HuffmanEncoder]") {
+    auto const sourceTable = buildTableStrings();
+
+    auto const checkTable = [&](auto const &table) {
+        for(std::size_t i{0}; i < sourceTable.size(); ++i) {
+            auto const s = table[i];
+            auto const expected = std::string{sourceTable[i]};
+
+            std::string iterated{s.begin(), s.end()};
+            std::string copied;
+            REQUIRE(s.copy_to(std::back_inserter(copied)) == expected.size());
+
+            REQUIRE(s.size() == expected.size());
+            REQUIRE_THAT(iterated, Equals(expected));
+            REQUIRE_THAT(copied, Equals(expected));
+        }
+    };
+
+    GIVEN("A tree decoded table split into 2 streams") {
+        auto const table = StringTable<BasicHuffmanEncoder<huffman::Options{.InterleaveThreshold = 16, .InterleaveStreams = 2}>>(buildTableStrings);
+
+        THEN("All strings should match the source data") {
+            checkTable(table);
+        }
+    }
+
+    GIVEN("A table decoded table split into 3 streams") {
+        auto const table = StringTable<BasicHuffmanEncoder<huffman::Options{.LookupBits = 8, .InterleaveThreshold = 16, .InterleaveStreams = 3}>>(buildTableStrings);
+
+        THEN("All strings should match the source data") {
+            checkTable(table);
+        }
+    }
+
+    GIVEN("A fast decoded canonical table split into 4 streams") {
+        auto const table = StringTable<BasicHuffmanEncoder<huffman::Options{
+            .LookupBits = 10, .MaxCodeLength = 12, .Decoder = huffman::DecodeMode::Fast, .InterleaveThreshold = 16}>>(buildTableStrings);
+
+        THEN("All strings should match the source data") {
+            checkTable(table);
+        }
+
+        WHEN("A string is decoded into a buffer that doesn't end on a whole set of streams") {
+            std::array<char, 11> buffer{};
+            auto const n = table[0].decode_into(buffer);
+
+            THEN("Only the start of the string that fits should be written") {
+                REQUIRE(n == buffer.size());
+                REQUIRE_THAT((std::string{buffer.data(), n}), Equals(std::string{sourceTable[0].substr(0, 11)}));
+            }
+        }
+    }
+
+    GIVEN("A fast decoded canonical table split into 2 streams, with codes longer than its lookup table") {
+        auto const table = StringTable<BasicHuffmanEncoder<huffman::Options{
+            .LookupBits = 4, .MaxCodeLength = 12, .Decoder = huffman::DecodeMode::Fast, .InterleaveThreshold = 16, .InterleaveStreams = 2}>>(buildTableStrings);
+
+        THEN("All strings should match the source data") {
+            checkTable(table);
+        }
+    }
+
+    GIVEN("A table with strings either side of the threshold") {
+        static constexpr auto makeStrings = [] {
+            return std::to_array<std::string_view>({"short", "", "exactly 16 chars", "a", "fifteen chars!!", "and one more than sixteen"});
+        };
+        auto const table = StringTable<BasicHuffmanEncoder<huffman::Options{.Decoder = huffman::DecodeMode::Fast, .InterleaveThreshold = 16}>>(makeStrings);
+        auto const source = makeStrings();
+
+        THEN("All strings should match the source data") {
+            for(std::size_t i{0}; i < source.size(); ++i) {
+                auto const s = table[i];
+                std::string iterated{s.begin(), s.end()};
+                std::string copied;
+                s.copy_to(std::back_inserter(copied));
+
+                REQUIRE_THAT(iterated, Equals(std::string{source[i]}));
+                REQUIRE_THAT(copied, Equals(std::string{source[i]}));
+            }
+        }
+    }
+}
+
+SCENARIO("StringTable<BasicHuffmanEncoder> strings can be accessed at random", "[StringTable][HuffmanEncoder]") {
+    auto const sourceTable = buildTableStrings();
+
+    auto const checkRandomAccess = [&](auto const &table) {
+        for(std::size_t i{0}; i < sourceTable.size(); ++i) {
+            auto const s = table[i];
+            auto const expected = std::string{sourceTable[i]};
+
+            // a spread of characters, and past the end
+            for(std::size_t c{0}; c < expected.size(); c += 7) {
+                REQUIRE(s.at(c) == expected[c]);
+            }
+            REQUIRE(s.at(expected.size() - 1) == expected.back());
+            REQUIRE(s.at(expected.size()) == '\0');
+
+            // substrings starting either side of checkpoints
+            for(std::size_t pos : {std::size_t{0}, std::size_t{1}, std::size_t{63}, std::size_t{64}, std::size_t{65}, std::size_t{500}, expected.size() - 3}) {
+                auto const sub = s.substr(pos, 70);
+                auto const expectedSub = expected.substr(pos, 70);
+
+                std::string iterated{sub.begin(), sub.end()};
+                std::string copied;
+                sub.copy_to(std::back_inserter(copied));
+
+                REQUIRE(sub.size() == expectedSub.size());
+                REQUIRE_THAT(iterated, Equals(expectedSub));
+                REQUIRE_THAT(copied, Equals(expectedSub));
+                REQUIRE(sub.at(2) == expectedSub[2]);
+            }
+
+            // advancing iterators, both within and past checkpoints
+            auto it = s.begin();
+            std::size_t position{0};
+            for(std::size_t step : {std::size_t{1}, std::size_t{10}, std::size_t{100}, std::size_t{3}, std::size_t{250}, std::size_t{64}}) {
+                it += step;
+                position += step;
+                REQUIRE(*it == expected[position]);
+            }
+
+            it += expected.size();
+            REQUIRE(it == s.end());
+        }
+    };
+
+    GIVEN("A table without checkpoints") {
+        auto const table = StringTable<HuffmanEncoder>(buildTableStrings);
+
+        THEN("Characters and substrings can still be accessed") {
+            checkRandomAccess(table);
+        }
+    }
+
+    GIVEN("A table with a checkpoint every 64 characters") {
+        using Encoder = BasicHuffmanEncoder<huffman::Options{.CheckpointInterval = 64}>;
+        auto const table = StringTable<Encoder>(buildTableStrings);
+
+        THEN("Characters and substrings can be accessed") {
+            checkRandomAccess(table);
+        }
+
+        THEN("The checkpoints should make the table larger") {
+            REQUIRE(sizeof(table) > sizeof(StringTable<HuffmanEncoder>(buildTableStrings)));
+        }
+    }
+
+    GIVEN("A fast decoded table with interleaved strings and a checkpoint every 32 characters") {
+        using Encoder = BasicHuffmanEncoder<huffman::Options{
+            .LookupBits = 10, .MaxCodeLength = 12, .Decoder = huffman::DecodeMode::Fast,
+            .InterleaveThreshold = 16, .InterleaveStreams = 4, .CheckpointInterval = 32}>;
+        auto const table = StringTable<Encoder>(buildTableStrings);
+
+        THEN("Characters and substrings can be accessed") {
+            checkRandomAccess(table);
+        }
+
+        THEN("Whole strings should still decode") {
+            for(std::size_t i{0}; i < sourceTable.size(); ++i) {
+                std::string copied;
+                table.copy_to(i, std::back_inserter(copied));
+                REQUIRE_THAT(copied, Equals(std::string{sourceTable[i]}));
+            }
+        }
+    }
+
+    GIVEN("A table where only long strings have checkpoints") {
+        static constexpr auto makeStrings = [] {
+            return std::to_array<std::string_view>({"short string", buildTableStrings()[0]});
+        };
+        using Encoder = BasicHuffmanEncoder<huffman::Options{.LookupBits = 8, .CheckpointInterval = 16, .CheckpointThreshold = 100}>;
+        auto const table = StringTable<Encoder>(makeStrings);
+        auto const source = makeStrings();
+
+        THEN("Both strings can be accessed") {
+            REQUIRE(table[0].at(6) == 's');
+            REQUIRE(table[1].at(1000) == source[1][1000]);
+
+            auto const sub = table[0].substr(6);
+            REQUIRE_THAT((std::string{sub.begin(), sub.end()}), Equals("string"));
+        }
+    }
+}
@@ -0,0 +1,90 @@
+#include <catch2/catch.hpp>
+#include <climits>
+#include <string>
+
+#include <squeeze/squeeze.h>
+
+using namespace squeeze;
+using Catch::Matchers::Equals;
+
+static auto buildTableStrings = [] {
+    return std::to_array<std::string_view> ({
+        "failed to open connection: timeout",
+        "failed to close connection: timeout",
+        "",
+        "QZXJ#@!%",
+        "connection reset by peer",
+        "K9",
+        "the connection to the server was closed by the remote host",
+        "the connection to the server could not be opened in time",
+        "the server sent a response that could not be read",
+        "the request was sent to the server but no response was seen",
+        "the server is not accepting connections on this port",
+    });
+};
+
+
+SCENARIO("StringTable<HybridEncoder> stores strings of rare characters raw", "[StringTable][HybridEncoder]")
+{
+    GIVEN("A StringTable with HybridEncoder") {
+        auto const table = StringTable<HybridEncoder>(buildTableStrings);
+
+        THEN("Strings of rare characters should be stored raw, and read in place") {
+            REQUIRE(table[3].raw().has_value());
+            REQUIRE(table[3].raw().value() == "QZXJ#@!%");
+            REQUIRE(table[5].raw().value() == "K9");
+        }
+
+        THEN("Strings of common characters should be coded") {
+            REQUIRE_FALSE(table[0].raw().has_value());
+            REQUIRE_FALSE(table[4].raw().has_value());
+        }
+
+        THEN("The table should be smaller than coding every string") {
+            auto const huffman = StringTable<CanonicalHuffmanEncoder>(buildTableStrings);
+            REQUIRE(sizeof(table) < sizeof(huffman));
+        }
+
+        THEN("Every coded string should be smaller than stored raw, with the code it is stored with") {
+            static constexpr auto encoding = HybridEncoder::Compile(buildTableStrings);
+            std::size_t end{encoding.NumEncodedBits};
+            for(std::size_t idx{encoding.NumEntries}; idx-- > 0; ) {
+                if(!encoding.m_IsRaw.at(idx)) {
+                    auto const entry = encoding.m_Entries[idx];
+                    REQUIRE(end - entry.FirstBit < entry.OriginalStringLength * CHAR_BIT);
+                    end = entry.FirstBit;
+                }
+            }
+        }
+
+        THEN("Raw strings can be copied in bulk") {
+            std::string copy;
+            REQUIRE(table.copy_to(3, std::back_inserter(copy)) == 8);
+            REQUIRE_THAT(copy, Equals("QZXJ#@!%"));
+        }
+    }
+
+    GIVEN("A StringTable whose code would take more space than it saves") {
+        static constexpr auto buildShortStrings = [] {
+            return std::to_array<std::string_view>({ "aaaaaaaa", "bbbbbbbb" });
+        };
+        auto const table = StringTable<HybridEncoder>(buildShortStrings);
+
+        THEN("Every string should be stored raw, with no code") {
+            REQUIRE(table[0].raw().value() == "aaaaaaaa");
+            REQUIRE(table[1].raw().value() == "bbbbbbbb");
+            REQUIRE(sizeof(table) < sizeof(StringTable<CanonicalHuffmanEncoder>(buildShortStrings)));
+        }
+    }
+
+    GIVEN("A StringTable where no strings are coded") {
+        auto const table = StringTable<HybridEncoder>([] {
+            return std::to_array<std::string_view>({ "", "" });
+        });
+
+        THEN("Every string should be read in place") {
+            REQUIRE(table[0].raw().has_value());
+            REQUIRE(table[1].size() == 0);
+        }
+    }
+}
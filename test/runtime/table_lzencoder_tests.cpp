@@ -0,0 +1,50 @@
+#include <catch2/catch.hpp>
+
+#include <squeeze/squeeze.h>
+
+using namespace squeeze;
+
+static auto buildTableStrings = [] {
+    return std::to_array<std::string_view> ({
+        "failed to open connection: timeout",
+        "failed to close connection: timeout",
+        "failed to read from connection",
+        "failed to write to connection",
+        "connection reset by peer",
+        "timeout waiting for connection",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+    });
+};
+
+
+SCENARIO("StringTable<LzEncoder> stores repeats as matches", "[StringTable][LzEncoder]")
+{
+    GIVEN("A StringTable with literals stored as bytes") {
+        auto const table = StringTable<LzEncoder>(buildTableStrings);
+
+        THEN("Repeated phrases should be stored as matches") {
+            REQUIRE(sizeof(table) < sizeof(StringTable<NilEncoder>(buildTableStrings)));
+        }
+    }
+
+    GIVEN("A StringTable with literals Huffman coded") {
+        auto const table = StringTable<HuffmanLzEncoder>(buildTableStrings);
+
+        THEN("Only matches costing less than their literals should be taken, so it is smaller than the codes alone") {
+            REQUIRE(sizeof(table) < sizeof(StringTable<CanonicalHuffmanEncoder>(buildTableStrings)));
+        }
+    }
+
+    GIVEN("A StringTable of one long run of a character") {
+        static constexpr auto makeRun = [] {
+            return std::to_array<std::string_view>({
+                "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"
+            });
+        };
+        auto const table = StringTable<LzEncoder>(makeRun);
+
+        THEN("The run should be stored as a literal then matches copying it") {
+            REQUIRE(sizeof(table) < makeRun()[0].size() / 4);
+        }
+    }
+}
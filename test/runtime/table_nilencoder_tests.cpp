@@ -49,3 +49,106 @@ SCENARIO("StringTable<NilEncoder> Can provide the correct strings", "[StringTabl
 
     }
 }
+
+SCENARIO("StringTable<NilEncoder> can copy whole strings in bulk", "[StringTable][NilEncoder]")
+{
+    GIVEN("A runtime initialised StringTable<NilEncoder>") {
+        auto const table = StringTable<NilEncoder>(buildTableStrings);
+
+        WHEN("A string is decoded into a small buffer") {
+            std::array<char, 5> buffer{};
+            auto const n = table.decode_into(1, buffer);
+
+            THEN("Only the start of the string that fits should be written") {
+                REQUIRE_THAT((std::string{buffer.data(), n}), Equals("Secon"));
+            }
+        }
+
+        WHEN("A string is copied to an output iterator") {
+            std::string extracted;
+            auto const n = table.copy_to(0, std::back_inserter(extracted));
+
+            THEN("The whole string should be written") {
+                REQUIRE(n == 12);
+                REQUIRE_THAT(extracted, Equals("First String"));
+            }
+        }
+    }
+}
+
+SCENARIO("StringTable<NilEncoder> uses the narrowest offsets", "[StringTable][NilEncoder]")
+{
+    GIVEN("A table with less than 256 characters of storage") {
+        using Data = decltype(NilEncoder::Compile(buildTableStrings));
+
+        THEN("Each string offset should be a single byte") {
+            STATIC_REQUIRE(std::is_same_v<Data::OffsetType, std::uint8_t>);
+        }
+    }
+
+    GIVEN("A table with more than 256 characters of storage") {
+        static constexpr auto makeStrings = [] {
+            return std::to_array<std::string_view>({
+                "A123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789",
+                "B123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789",
+                "C123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789",
+                "last"
+            });
+        };
+        using Data = decltype(NilEncoder::Compile(makeStrings));
+        auto const table = StringTable<NilEncoder>(makeStrings);
+
+        THEN("Each string offset should be 16 bits") {
+            STATIC_REQUIRE(std::is_same_v<Data::OffsetType, std::uint16_t>);
+        }
+
+        THEN("Strings past the first 256 characters should be correct") {
+            REQUIRE_THAT(std::string{table[3]}, Equals("last"));
+        }
+    }
+}
+
+SCENARIO("StringTable<NilEncoder> shares the storage of duplicate strings and suffixes", "[StringTable][NilEncoder]")
+{
+    static constexpr auto makeStrings = [] {
+        return std::to_array<std::string_view>({
+            "error",
+            "parse error",
+            "",
+            "file not found",
+            "parse error",
+            "not found",
+            "found",
+            "ror"
+        });
+    };
+    auto const source = makeStrings();
+
+    GIVEN("A table where most strings are duplicates or suffixes of others") {
+        using Data = decltype(NilEncoder::Compile(makeStrings));
+        auto const table = StringTable<NilEncoder>(makeStrings);
+
+        THEN("Only the longest strings should be stored") {
+            STATIC_REQUIRE(std::tuple_size_v<decltype(Data::m_Storage)> == std::string_view{"parse errorfile not found"}.size());
+        }
+
+        THEN("Every string should match the source data") {
+            for(std::size_t i{0}; i < source.size(); ++i) {
+                REQUIRE_THAT(std::string{table[i]}, Equals(std::string{source[i]}));
+            }
+        }
+
+        THEN("Duplicate strings should be the same storage") {
+            REQUIRE(table[1].data() == table[4].data());
+            REQUIRE(table[0].data() == table[1].data() + 6);
+        }
+    }
+
+    GIVEN("A table with nothing to share") {
+        using Data = decltype(NilEncoder::Compile(buildTableStrings));
+
+        THEN("The strings should be stored end to end without their lengths") {
+            STATIC_REQUIRE(sizeof(Data) == 2 + std::string_view{"First StringSecond String"}.size());
+        }
+    }
+}
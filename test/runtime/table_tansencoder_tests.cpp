@@ -0,0 +1,85 @@
+#include <catch2/catch.hpp>
+#include <string>
+
+#include <squeeze/squeeze.h>
+
+using namespace squeeze;
+using Catch::Matchers::Equals;
+
+// 9 in every 10 characters are the same, which Huffman can code in no less than 1 bit each
+static constexpr auto SkewedText = [] {
+    std::array<char, 4000> text{};
+    for(std::size_t i{0}; i < text.size(); ++i) {
+        text.at(i) = (i % 10 == 9) ? 'b' : 'a';
+    }
+    return text;
+}();
+
+static auto buildSkewedStrings = [] {
+    return std::to_array<std::string_view> ({
+        std::string_view{SkewedText.data(), 2000},
+        // not a copy or suffix of the first, so the Huffman table can't share it
+        std::string_view{SkewedText.data() + 2000, 1995},
+    });
+};
+
+
+SCENARIO("StringTable<TansEncoder> codes characters in fractions of a bit", "[StringTable][TansEncoder]")
+{
+    GIVEN("A StringTable of strings with a skewed character distribution") {
+        auto const table = StringTable<TansEncoder>(buildSkewedStrings);
+
+        THEN("Every string should be decoded") {
+            auto const s = table[1];
+            REQUIRE_THAT((std::string{s.begin(), s.end()}), Equals(std::string{buildSkewedStrings().at(1)}));
+        }
+
+        THEN("Characters should be stored in less than a bit each") {
+            auto const huffman = StringTable<HuffmanEncoder>(buildSkewedStrings);
+            REQUIRE(sizeof(table) < sizeof(huffman));
+        }
+    }
+}
+
+
+SCENARIO("StringTable<TansEncoder> picks the table size with the smallest footprint", "[StringTable][TansEncoder]")
+{
+    // a few lines of English
+    static constexpr auto makeLines = [] {
+        return std::to_array<std::string_view>({
+            "The quick brown fox jumps over the lazy dog near the river bank.",
+            "A journey of a thousand miles begins with a single step.",
+            "Please check your network settings and try again later.",
+            "Every morning she walked along the beach collecting shells.",
+            "Nothing is certain except death and taxes.",
+            "The meeting has been moved to Thursday afternoon at three o'clock.",
+            "Keep calm and carry on.",
+            "Bright stars filled the cold winter sky above the quiet village below.",
+            "He forgot his umbrella, so he got soaked on the way home.",
+            "Music gives a soul to the universe and wings to the mind.",
+        });
+    };
+
+    GIVEN("Tables of the default size and of fixed sizes") {
+        using Default = decltype(TansEncoder::Compile(makeLines));
+        using Small = decltype(BasicTansEncoder<tans::Options{.TableLog = 6}>::Compile(makeLines));
+        using Medium = decltype(BasicTansEncoder<tans::Options{.TableLog = 8}>::Compile(makeLines));
+        using Large = decltype(BasicTansEncoder<tans::Options{.TableLog = 11}>::Compile(makeLines));
+
+        THEN("The default should be no larger than any of them") {
+            STATIC_REQUIRE(sizeof(Default) <= sizeof(Small));
+            STATIC_REQUIRE(sizeof(Default) <= sizeof(Medium));
+            STATIC_REQUIRE(sizeof(Default) <= sizeof(Large));
+        }
+    }
+
+    GIVEN("Strings with a skewed character distribution") {
+        using Default = decltype(TansEncoder::Compile(buildSkewedStrings));
+        using Large = decltype(BasicTansEncoder<tans::Options{.TableLog = 11}>::Compile(buildSkewedStrings));
+
+        THEN("A small table should be picked, as a few states follow two characters closely enough") {
+            STATIC_REQUIRE(sizeof(Default) < sizeof(Large));
+            STATIC_REQUIRE(std::tuple_size_v<decltype(Default::m_Table)> <= 64);
+        }
+    }
+}
@@ -0,0 +1,45 @@
+#include <catch2/catch.hpp>
+
+#include <squeeze/squeeze.h>
+
+using namespace squeeze;
+
+static auto buildTableStrings = [] {
+    return std::to_array<std::string_view> ({
+        "failed to open connection: timeout",
+        "failed to close connection: timeout",
+        "failed to read from connection",
+        "failed to write to connection",
+        "connection reset by peer",
+        "timeout waiting for connection",
+        "connection refused by peer",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+    });
+};
+
+
+SCENARIO("StringTable<TokenEncoder> stores repeated phrases as tokens", "[StringTable][TokenEncoder]")
+{
+    GIVEN("A StringTable with TokenEncoder") {
+        auto const table = StringTable<TokenEncoder>(buildTableStrings);
+
+        THEN("Repeated phrases should be stored as tokens") {
+            REQUIRE(sizeof(table) < sizeof(StringTable<NilEncoder>(buildTableStrings)));
+        }
+
+        THEN("Longer tokens should cover more of each phrase than a few short ones") {
+            using ShortTokenEncoder = BasicTokenEncoder<token::Options{.MaxTokens = 4, .MaxTokenLength = 2}>;
+            REQUIRE(sizeof(table) < sizeof(StringTable<ShortTokenEncoder>(buildTableStrings)));
+        }
+    }
+
+    GIVEN("A string that is a run of one character") {
+        // 7 overlapping pairs, but only 4 can be replaced, which doesn't pay for the token's 2 characters and offset
+        static constexpr auto buildRun = [] { return std::to_array<std::string_view>({ "aaaaaaaa" }); };
+        constexpr auto grammar = token::BuildGrammar<token::Options{}, 8, 1>(buildRun);
+
+        THEN("Only the pairs that can be replaced should be counted") {
+            STATIC_REQUIRE(grammar.NumTokens == 0);
+        }
+    }
+}